@@ -0,0 +1,83 @@
+#ifndef _COMPRESSED_PATH_BASE_H_
+#define _COMPRESSED_PATH_BASE_H_
+
+#include "path.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using std::vector;
+using std::string;
+using Utilities::Point;
+using Utilities::PathSegment;
+using Utilities::Path;
+
+/*
+    A routed path kept as a chain code, for holding many routes at once. It stores the
+    cell the route starts on and then one byte per run of steps in the same direction:
+    the low two bits are the direction (+x, +y, -x, -y), the high six bits the number
+    of steps less one. A run longer than 64 cells takes several bytes, so a straight
+    500 cell route costs 8 bytes where 500 unit PathSegments cost 10000.
+
+    Nothing is expanded to use it. The iterator rebuilds one straight segment at a
+    time from the runs, and contains() and get_length() work on the runs directly.
+    The router daemon keeps its solution this way between requests.
+*/
+
+namespace Utilities {
+    class CompressedPath {
+        private:
+            string name;
+            Point source;
+            Point sink;
+            Point start;                // the cell the first run steps from
+            vector<uint8_t> runs;
+            int length;
+            unsigned segments;
+
+            void add_run(int direction, int steps);
+
+        public:
+            /* Walks the straight segments of the path, building each one as it gets to it */
+            class const_iterator {
+                private:
+                    const CompressedPath* path;
+                    unsigned run;           // first run of the current segment
+                    unsigned next_run;      // first run of the segment after it
+                    Point head;
+                    Point tail;
+
+                    void load();
+
+                public:
+                    const_iterator(const CompressedPath* path, unsigned run, Point head);
+
+                    PathSegment operator*() const;
+                    const_iterator& operator++();
+                    bool operator==(const const_iterator& rhs) const;
+                    bool operator!=(const const_iterator& rhs) const;
+            };
+
+            /* Constructors/Destructors */
+            CompressedPath();
+            ~CompressedPath();
+
+            /* Accessors */
+            string get_name() const;
+            Point get_source() const;
+            Point get_sink() const;
+            unsigned size() const;
+            bool empty() const;
+            bool contains(const Point& point) const;
+            int get_length() const;
+            unsigned encoded_size() const;
+            const_iterator begin() const;
+            const_iterator end() const;
+            Path expand() const;
+
+            /* Mutators */
+            bool encode(const Path& path);
+    };
+}
+
+#endif //_COMPRESSED_PATH_BASE_H_
@@ -0,0 +1,72 @@
+#ifndef _DSTAR_LITE_BASE_H_
+#define _DSTAR_LITE_BASE_H_
+
+#include "map.h"
+#include "path.h"
+#include <vector>
+#include <set>
+#include <utility>
+
+using std::vector;
+using std::set;
+using std::pair;
+using Utilities::Map;
+using Utilities::Path;
+
+/*
+    Incremental router for a single connection (D* Lite, Koenig & Likhachev 2002).
+
+    The search runs backwards from the sink, so g() of every cell is its distance to the
+    sink and the path is read off forwards from the source. The g/rhs values and the open
+    list are kept between calls: when cells of the Map flip between free and blocked the
+    caller passes them to update_cells() and compute_shortest_path() only repairs the
+    part of the search that the change made inconsistent.
+*/
+
+namespace Utilities {
+    typedef pair<int, int> DStarKey;
+
+    class DStarLite {
+        private:
+            Map* map;
+            Point source;
+            Point sink;
+            int width;
+            int height;
+            int expansions;             // cells expanded by the last compute_shortest_path()
+
+            vector<int> g;
+            vector<int> rhs;
+            vector<DStarKey> queued_key;    // key a cell was queued with, valid while in_queue
+            vector<bool> in_queue;
+            set<pair<DStarKey, int> > open;
+
+            int index(int x, int y);
+            int heuristic(int cell);
+            int edge_cost(int from, int to);
+            DStarKey calculate_key(int cell);
+            void queue_remove(int cell);
+            void queue_insert(int cell);
+            void update_vertex(int cell);
+
+        public:
+            /* Constructors/Destructors */
+            DStarLite(Map* map, Point source, Point sink);
+            ~DStarLite();
+
+            /* Accessors */
+            Point get_source();
+            Point get_sink();
+            int get_expansions();
+            int get_distance();
+            Path get_path();
+
+            /* Mutators */
+            void update_cells(const vector<Point>& changed);
+
+            /* Algorithms */
+            bool compute_shortest_path();
+    };
+}
+
+#endif //_DSTAR_LITE_BASE_H_
@@ -0,0 +1,114 @@
+#ifndef _ECO_BASE_H_
+#define _ECO_BASE_H_
+
+#include "map.h"
+#include "path.h"
+#include "compressed_path.h"
+#include "problem_object.h"
+#include "global_router.h"
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+using Utilities::Map;
+using Utilities::Path;
+using Utilities::CompressedPath;
+using Utilities::GlobalRouter;
+
+/*
+    Engineering change (ECO) support. A delta file lists blockers and routes to add or
+    remove on top of a problem that has already been routed:
+
+    {
+        "addBlockerList": [ {"name": "b9", "width": 2, "height": 2, "x": 4, "y": 7} ],
+        "removeBlockerList": [ {"name": "b1", "width": 1, "height": 10, "x": 5, "y": 0} ],
+        "addRouteList": [ {"name": "r9", "source_x": 1, "source_y": 1, "sink_x": 9, "sink_y": 3} ],
+        "removeRouteList": [ {"name": "r2"} ]
+    }
+
+    Every list is optional. Blockers to remove are matched by location and size.
+
+    Routes are rerouted with the GlobalRouter (soukup), whichever router produced the
+    previous solution: a solution file does not say which one did.
+*/
+
+namespace Utilities {
+    class EcoDelta {
+        private:
+            vector<Blocker> added_blockers;
+            vector<Blocker> removed_blockers;
+            vector<Connection> added_routes;
+            vector<string> removed_routes;
+
+        public:
+            /* Constructors/Destructors */
+            EcoDelta();
+            EcoDelta(string filename);
+            ~EcoDelta();
+
+            /* Accessors */
+            vector<Blocker> get_added_blockers() { return this->added_blockers; }
+            vector<Blocker> get_removed_blockers() { return this->removed_blockers; }
+            vector<Connection> get_added_routes() { return this->added_routes; }
+            vector<string> get_removed_routes() { return this->removed_routes; }
+
+            /* Mutators */
+            bool load(string filename);
+            void add_blocker(const Blocker& blocker);
+            void remove_blocker(const Blocker& blocker);
+    };
+
+    /* What an ECO run did to each route of the previous solution */
+    struct EcoDiff {
+        vector<string> added;
+        vector<string> removed;
+        vector<string> rerouted;
+        vector<string> failed;      // routes that had to be rerouted or added but are now invalid
+        unsigned unchanged;
+    };
+
+    /* A cell rectangle touched by the delta, inclusive on both ends */
+    struct DirtyRect {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+    };
+
+    class EcoRouter {
+        private:
+            Map* map;
+            GlobalRouter* router;       // shared with the caller, or NULL for one of apply()'s own
+            vector<DirtyRect> dirty;
+            vector<Point> changed;      // cells that flipped between free and blocked
+            bool reporting;             // let the reroutes claim warnings and corridor sizes
+
+            void mark_dirty(Blocker changed);
+            bool crosses_dirty(Point source, Point sink);
+            bool crosses_dirty(const Path& path);
+            bool crosses_dirty(const CompressedPath& path);
+            template <typename StoredPath>
+            vector<StoredPath> update(vector<StoredPath> previous, EcoDelta* delta, EcoDiff* diff);
+
+        public:
+            /* Constructors/Destructors */
+            EcoRouter(Map* map, GlobalRouter* router = NULL);
+            ~EcoRouter();
+
+            /* Accessors */
+            vector<DirtyRect> get_dirty();
+            vector<Point> get_changed();
+
+            /* Mutators */
+            void set_reporting(bool reporting);
+
+            /* Algorithms */
+            vector<Path> apply(vector<Path> previous, EcoDelta* delta, EcoDiff* diff);
+            vector<CompressedPath> apply(vector<CompressedPath> previous, EcoDelta* delta, EcoDiff* diff);
+    };
+
+    void write_eco_diff(string filename, const EcoDiff& diff);
+}
+
+#endif //_ECO_BASE_H_
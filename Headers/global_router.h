@@ -0,0 +1,83 @@
+#ifndef _GLOBAL_ROUTER_BASE_H_
+#define _GLOBAL_ROUTER_BASE_H_
+
+#include "map.h"
+#include "path.h"
+#include "compressed_path.h"
+#include "problem_object.h"
+#include <vector>
+
+using std::vector;
+using Utilities::Map;
+using Utilities::Path;
+using Utilities::CompressedPath;
+
+/*
+    Two level (Soukup style) router. The Map is covered by a coarse grid of square
+    tiles (GCells), each tile_size x tile_size cells. A connection is first routed
+    over the tiles, which picks a corridor, and the detailed maze search is then
+    only allowed to expand inside that corridor. All detailed search scratch is
+    indexed by corridor slot, so it is sized to the corridor rather than the Map.
+    When the Map has a RouteReport set, route() adds every connection to it.
+*/
+
+namespace Utilities {
+    struct GCell {
+        int free_cells;     // cells of the tile not covered by a blocker
+        int capacity;       // routes the tile can carry, derived from free_cells
+        int usage;          // routes the global router has sent through the tile
+    };
+
+    class GlobalRouter {
+        private:
+            Map* map;
+            int tile_size;
+            int tiles_x;
+            int tiles_y;
+            bool reporting;                 // claim routing warnings and corridor sizes
+            vector<GCell> gcells;           // row major, tiles_x * tiles_y
+
+            /* Detailed search scratch, reused between connections */
+            vector<int> corridor_slot;      // tile -> slot in the current corridor, -1 if outside
+            vector<signed char> came_from;  // per corridor cell, direction we entered it from
+
+            void build_gcells();
+            int tile_index(int x, int y);
+            int cell_index(int x, int y);
+            int entry_cost(int tile);
+            int add_usage(const PathSegment& segment, int last_tile, int amount);
+            void add_usage(const Path& path, int amount);
+            void add_usage(const CompressedPath& path, int amount);
+
+        public:
+            /* Constructors/Destructors */
+            GlobalRouter(Map* map, int tile_size = 16);
+            ~GlobalRouter();
+
+            /* Accessors */
+            int get_tile_size();
+            int get_tiles_x();
+            int get_tiles_y();
+            GCell get_gcell(int tile_x, int tile_y);
+
+            /* Mutators */
+            void reset_usage();
+            void charge(const Path& path);
+            void charge(const CompressedPath& path);
+            void release(const Path& path);
+            void release(const CompressedPath& path);
+            void set_reporting(bool reporting);
+            void update_cells(const vector<Point>& changed);
+
+            /* Algorithms */
+            vector<int> global_route(Point source, Point sink);
+            vector<int> corridor(const vector<int>& tile_path, int halo);
+            bool detailed_route(Point source, Point sink, const vector<int>& corridor, Path* path,
+                                RouteStats* stats = NULL);
+            bool route(const Connection& connection, Path* path);
+            vector<Path> route(const vector<Connection>& connections);
+            void route(const vector<Connection>& connections, PathSink* sink);
+    };
+}
+
+#endif //_GLOBAL_ROUTER_BASE_H_
@@ -3,7 +3,9 @@
 
 #include "node.h"
 #include "path.h"
+#include "path_sink.h"
 #include "problem_object.h"
+#include "route_stats.h"
 #include <vector>
 #include <queue>
 
@@ -19,41 +21,59 @@ namespace Utilities {
 		vector<vector<Node*> > map;
 		int num_connections;
 		bool found_end;    // added, used to end wave expansion and bactracing
-		vector<Path*> paths;
+		vector<Path> paths;
 		vector<Connection> connections;     // added, easy access to p_o connections
+		vector<Blocker> blockers;    // added, blockers currently applied to the map
+		RouteReport* report;    // added, gets the search statistics of every connection when set
+
+		void build_nodes(int width, int height);    // added
 
 	public:
 		/* Constructors/Destructors */
 		Map(ProblemObject* problem_object);
+		explicit Map(ProblemObject&& problem_object);    // added, takes over the connections
+		Map(int width, int height, const vector<Blocker>& blockers);    // added
 		~Map();
 
 		/* Accessors */
 		int get_width();
 		int get_height();
 		int get_num_connections();
+		const vector<Connection>& get_connections();
+		const vector<Blocker>& get_blockers();    // added
+		bool is_blocked(int x, int y);    // added
 		Node* get_node(int x, int y);
 		Node* get_node(Point coord);
-		vector<Path*> get_paths();
-		Path* get_path(int i);
+		const vector<Path>& get_paths();
+		Path& get_path(int i);
+		RouteReport* get_report();    // added
 
 		/* Mutators */
 		void replace_node(Node* replacement_node);
-		void set_paths(vector<Path*> paths);
-		bool validate_blockers(Blocker block, int max_width, int max_height); // added
-		void set_blockers(vector<Blocker> blockers);    // added
-		bool validate_connections(Connection connections, int path);    //added
-		void wave_expansion(Node* source);	// added
+		void set_paths(vector<Path> paths);
+		void set_report(RouteReport* report);    // added
+		bool validate_blockers(const Blocker& block, int max_width, int max_height); // added
+		void set_blockers(const vector<Blocker>& blockers);    // added
+		vector<Point> add_blocker(Blocker blocker);    // added
+		vector<Point> remove_blocker(Blocker blocker);    // added
+		bool validate_connections(const Connection& connections, int path);    //added
+		void wave_expansion(Node* source, RouteStats* stats = NULL);	// added
 		Path* backtrace(Node* sink, Path* path);    // added
         bool traceable(Node* sink);    // added
         bool simple_path(Node* source, Node* sink, int path); //added
-		void add_path(Path* path);
-		void replace_path(int i, Path* path);
+		void add_path(Path path);
+		void replace_path(int i, Path path);
 		void remove_path(int i);
 		void print_map();    // added
 
 		/* Algorithms */
-		vector<Path*> lee();
-		vector<Path*> test_algorithm();
+		vector<Path> lee();
+		void lee(PathSink* sink);    // added
+		bool lee_route(const Connection& connection, int index, Path* path);    // added
+		vector<Path> soukup(int tile_size = 16);    // added
+		void soukup(PathSink* sink, int tile_size = 16);    // added
+		vector<Path> dstar(ProblemObject* changes = NULL);    // added
+		vector<Path> test_algorithm();
 	};
 }
 
@@ -15,21 +15,28 @@ namespace Utilities {
             vector<Point> sinks;
 
         public:
+            /* Value type, like Path */
             Netlist();
+            Netlist(const Netlist&) = default;
+            Netlist(Netlist&&) = default;
+            Netlist& operator=(const Netlist&) = default;
+            Netlist& operator=(Netlist&&) = default;
             ~Netlist();
 
             /* Accessors */
-            Point get_source();
-            vector<Point> get_sinks();
+            Point get_source() const;
+            const vector<Point>& get_sinks() const;
 
             /* 
             == Inherited Accessors ==
             unsigned size() const;
-            PathSegment* at(unsigned index) const;
+            const PathSegment& at(unsigned index) const;
             bool empty() const;
-            bool contains(const Point& point);
-            int get_length();
-            void print();
+            bool contains(const Point& point) const;
+            bool intersects(Point source, Point sink) const;
+            bool is_indexed() const;
+            int get_length() const;
+            void print() const;
             */
 
             /* Mutators */
@@ -38,9 +45,12 @@ namespace Utilities {
 
             /*
             == Inherited Mutators ==
-            void add_segment(PathSegment* pathsegment);
+            void build_index();
+            void drop_index();
+            void reserve(unsigned segments);
+            void add_segment(const PathSegment& pathsegment);
             void add_segment(Point source, Point sink);
-            void remove_segment(PathSegment* pathsegment);
+            void remove_segment(const PathSegment& pathsegment);
             void remove_segment(Point soruce, Point sink);
             void remove_segment(int index);
             */
@@ -0,0 +1,89 @@
+#ifndef _OVERLAP_CHECKER_BASE_H_
+#define _OVERLAP_CHECKER_BASE_H_
+
+#include "path.h"
+#include "path_sink.h"
+#include "problem_object.h"
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+using Utilities::Point;
+using Utilities::Path;
+
+/*
+    Checks a routed solution for shorts, two different paths on the same cell, and for
+    paths that run over a blocker. It can be handed paths one at a time, as a PathSink
+    or through add_path, and only keeps the cell rectangle of each straight segment.
+
+    check() sweeps a line across x. Every segment and blocker is a rectangle of cells;
+    it is added to an interval tree over y when the sweep reaches its left column and
+    taken out after its right column. Before going in, the tree is asked for every
+    rectangle still in it whose y range meets the new one, those are the overlaps.
+    That is O(n log n) for n segments and blockers plus O(log n) per overlap found,
+    where checking each segment against every other would be O(n^2).
+*/
+
+namespace Utilities {
+    enum OverlapKind {
+        kShort,             // two paths share cells
+        kBlocked            // a path runs over a blocker
+    };
+
+    struct Overlap {
+        OverlapKind kind;
+        unsigned first;     // index of the path, in the order the paths were added
+        unsigned second;    // index of the other path (kShort) or of the blocker (kBlocked)
+        Point from;         // the cells both cover run from here to 'to', inclusive
+        Point to;
+    };
+
+    class OverlapChecker : public PathSink {
+        private:
+            /* A rectangle of cells, inclusive on both ends, owned by a path (owner >= 0) or a blocker (owner < 0) */
+            struct Box {
+                int x1;
+                int y1;
+                int x2;
+                int y2;
+                int owner;
+            };
+
+            vector<Box> boxes;
+            vector<string> path_names;
+            unsigned num_paths;
+            unsigned num_blockers;
+
+            /* The interval tree, over the boxes sorted by y1 */
+            vector<unsigned> by_low;        // box indices sorted by y1
+            vector<int> lows;               // their y1s, in the same order
+            vector<int> max_high;           // per tree node, the largest y2 of the boxes in it that are in the sweep
+            unsigned leaves;
+
+            void build_tree();
+            void set_in_sweep(unsigned position, int high);
+            void find_overlaps(unsigned node, unsigned lo, unsigned hi, unsigned box, vector<Overlap>* found) const;
+
+        public:
+            /* Constructors/Destructors */
+            OverlapChecker();
+            ~OverlapChecker();
+
+            /* Accessors */
+            unsigned get_num_paths() const;
+            unsigned get_num_segments() const;
+            string get_path_name(unsigned index) const;
+
+            /* Mutators */
+            void add_path(const Path& path);
+            void add_paths(const vector<Path>& paths);
+            void add_blockers(const vector<Blocker>& blockers);
+            void path_ready(Path& path);
+
+            /* Algorithms */
+            vector<Overlap> check();
+    };
+}
+
+#endif //_OVERLAP_CHECKER_BASE_H_
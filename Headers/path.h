@@ -3,44 +3,59 @@
 
 #include "segmentgroup.h"
 #include <vector>
+#include <string>
 
 using std::vector;
+using std::string;
 using Utilities::Point;
 using Utilities::PathSegment;
 
 namespace Utilities {
     class Path: public SegmentGroup {
         private:
+            string name;
             Point source;
             Point sink;
 
         public:
+            /* Value type: routers return Paths by value and they are moved, not copied, into place */
             Path();
+            Path(const Path&) = default;
+            Path(Path&&) = default;
+            Path& operator=(const Path&) = default;
+            Path& operator=(Path&&) = default;
             ~Path();
 
             /* Accessors */
-            Point get_source();
-            Point get_sink();
+            string get_name() const;
+            Point get_source() const;
+            Point get_sink() const;
 
             /* 
             == Inherited Accessors ==
             unsigned size() const;
-            PathSegment* at(unsigned index) const;
+            const PathSegment& at(unsigned index) const;
             bool empty() const;
-            bool contains(const Point& point);
-            int get_length();
-            void print();
+            bool contains(const Point& point) const;
+            bool intersects(Point source, Point sink) const;
+            bool is_indexed() const;
+            int get_length() const;
+            void print() const;
             */
 
             /* Mutators */
+            void set_name(string name);
             void set_source(Point source);
             void set_sink(Point sink);
 
             /*
             == Inherited Mutators ==
-            void add_segment(PathSegment* pathsegment);
+            void build_index();
+            void drop_index();
+            void reserve(unsigned segments);
+            void add_segment(const PathSegment& pathsegment);
             void add_segment(Point source, Point sink);
-            void remove_segment(PathSegment* pathsegment);
+            void remove_segment(const PathSegment& pathsegment);
             void remove_segment(Point soruce, Point sink);
             void remove_segment(int index);
             */
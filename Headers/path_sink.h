@@ -0,0 +1,48 @@
+#ifndef _PATH_SINK_BASE_H_
+#define _PATH_SINK_BASE_H_
+
+#include "path.h"
+#include <vector>
+#include <utility>
+
+using std::vector;
+using Utilities::Path;
+
+/*
+    Where a router hands each path as soon as its connection is routed, instead of
+    holding every path until the last connection is done. A sink that prints or writes
+    the path and lets it go keeps peak memory down to one path, and whatever reads the
+    output can start on the first routes while the rest are still being routed.
+*/
+
+namespace Utilities {
+    class PathSink {
+        public:
+            virtual ~PathSink() { }
+            // Called once per routed path, in routing order, on the routing thread. The path may be moved from
+            virtual void path_ready(Path& path) = 0;
+    };
+
+    /* Keeps every path, for callers that want the whole vector back */
+    class PathCollector : public PathSink {
+        private:
+            vector<Path> paths;
+
+        public:
+            void path_ready(Path& path) { this->paths.push_back(std::move(path)); }
+            vector<Path> release() { return std::move(this->paths); }
+    };
+
+    /* Hands each path to two sinks, the first must not move from it */
+    class PathTee : public PathSink {
+        private:
+            PathSink* first;
+            PathSink* second;
+
+        public:
+            PathTee(PathSink* first, PathSink* second) { this->first = first; this->second = second; }
+            void path_ready(Path& path) { this->first->path_ready(path); this->second->path_ready(path); }
+    };
+}
+
+#endif //_PATH_SINK_BASE_H_
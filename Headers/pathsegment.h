@@ -19,16 +19,16 @@ namespace Utilities {
             ~PathSegment();
 
             /* Overloaded Operators */
-            bool operator==(const PathSegment& rhs);
+            bool operator==(const PathSegment& rhs) const;
 
             /* Accessors */
-            Point get_source();
-            Point get_sink();
-            int get_length();
-            bool contains_points(Point source, Point sink);
-            void print_source();
-            void print_sink();
-            void print();
+            Point get_source() const;
+            Point get_sink() const;
+            int get_length() const;
+            bool contains_points(Point source, Point sink) const;
+            void print_source() const;
+            void print_sink() const;
+            void print() const;
 
             /* Mutators */
             void set_source(Point source);          
@@ -0,0 +1,76 @@
+#ifndef _PIPELINE_BASE_H_
+#define _PIPELINE_BASE_H_
+
+#include "map.h"
+#include "path.h"
+#include "problem_object.h"
+#include "problem_builder.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+using std::vector;
+using std::deque;
+using std::string;
+using Utilities::Path;
+
+/*
+    Pipelined load and route (grid_router <test_file> --pipeline). The problem file is
+    parsed on its own thread. As soon as the size and blockers are known the Map is
+    built on the routing thread, and every connection the parser finishes is queued and
+    routed with Lee's algorithm straight away, while the rest of the routeList is still
+    being parsed.
+
+    Connections are routed in file order, so the paths are the ones lee() finds. Load
+    warnings are reported once the whole file has been parsed. A current compiled image
+    (see --compile) loads faster than it can be pipelined and is routed directly.
+*/
+
+namespace Utilities {
+    class PipelinedRouter : public ProblemListener {
+        private:
+            string filename;
+
+            /* Shared with the parsing thread */
+            std::mutex lock;
+            std::condition_variable changed;
+            bool ready;                     // size and blockers known
+            bool finished;                  // parser done, nothing more will be queued
+            unsigned int width;
+            unsigned int height;
+            vector<Blocker> blockers;
+            deque<Connection> queue;
+            RouteReport* report;            // handed to the Map route() builds
+
+            /* Timings of the last route(), milliseconds since it started */
+            double first_route_ms;
+            double parsed_ms;
+            double total_ms;
+
+        public:
+            /* Constructors/Destructors */
+            PipelinedRouter(string filename);
+            ~PipelinedRouter();
+
+            /* Accessors */
+            double get_first_route_ms();
+            double get_parsed_ms();
+            double get_total_ms();
+            const vector<Blocker>& get_blockers();
+
+            /* Mutators */
+            void set_report(RouteReport* report);
+
+            /* ProblemListener, called on the parsing thread */
+            void problem_ready(unsigned int width, unsigned int height, const vector<Blocker>& blockers);
+            void connection_ready(const Connection& connection);
+
+            /* Algorithms */
+            vector<Path> route();
+            void route(PathSink* sink);
+    };
+}
+
+#endif //_PIPELINE_BASE_H_
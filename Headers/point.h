@@ -12,7 +12,7 @@ namespace Utilities {
         ~Point() {}
 
         /* Overloaded Operators */
-        bool operator==(const Point& rhs) {
+        bool operator==(const Point& rhs) const {
             if(rhs.x == this->x && rhs.y == this->y) { 
                 return true; 
             }
@@ -0,0 +1,133 @@
+#ifndef _PROBLEM_BUILDER_H_
+#define _PROBLEM_BUILDER_H_
+
+#include "problem_object.h"
+#include "../Utilities/JSON_parser/Headers/json_handler.h"
+
+#include <vector>
+#include <string>
+
+using JSON::JsonString;
+using std::string;
+using std::vector;
+
+/*
+	Builds the contents of a ProblemObject straight from the parser's events, without
+	a JSON DOM. Blockers and connections are filled in as their objects are parsed, so
+	memory grows with the problem rather than with the file.
+
+	Reads the file the same way the DOM walk did: only the first top level object is
+	the problem, the first occurrence of a name wins, fields that are not ints read as
+	0, and list entries that are not objects are skipped. Warnings are left to the
+	caller, the counts needed for them are kept here.
+
+	With a listener set, the size and blockers are handed over as soon as the routeList
+	starts, if width, height and blockerList have all been read by then, and every
+	connection follows as it is parsed. Otherwise everything is handed over once the
+	problem object closes.
+
+	parse_problem() reads a large routeList on several threads: each run of its entries
+	goes to a builder of its own that starts out inside the routeList, the rest of the
+	file to the main builder, and the runs are appended to it in file order.
+*/
+
+namespace Utilities {
+	/*
+		Gets a problem handed over while it is still being parsed, so work can start
+		before the end of the file. Called on the parsing thread.
+	*/
+	class ProblemListener {
+		public:
+			virtual ~ProblemListener() { }
+			// Size and blockers are final, called once and before any connection_ready()
+			virtual void problem_ready(unsigned int width, unsigned int height, const vector<Blocker>& blockers) = 0;
+			// Called for every connection in file order
+			virtual void connection_ready(const Connection& connection) = 0;
+	};
+
+	class ProblemBuilder : public JSON::JsonHandler {
+		private:
+			enum Field {kOther,kName,kWidth,kHeight,kBlockerList,kRouteList,
+				kX,kY,kSourceX,kSourceY,kSinkX,kSinkY,kFieldCount};
+			enum List {kNoList,kBlockers,kRoutes};
+
+			string name;
+			unsigned int width;
+			unsigned int height;
+			vector<Connection> connections;
+			vector<Blocker> blockers;
+
+			/* What the file held, for the caller's warnings */
+			bool complete;				// the problem object was closed
+			bool blocker_list;			// blockerList was an array
+			bool route_list;			// routeList was an array
+			unsigned blocker_list_size;	// entries of any type in blockerList
+			unsigned route_list_size;
+			unsigned unnamed_blockers;
+			unsigned unnamed_connections;
+
+			/* Parse state */
+			int depth;					// objects and arrays currently open
+			int top_level_values;		// name-values open at the top level
+			bool in_problem;
+			List list;					// the list open at depth 2, if any
+			bool in_entry;				// inside an object of the list
+			Field field;				// field of the current name-value
+			unsigned problem_seen;		// fields already read, one bit per Field
+			unsigned entry_seen;
+			bool entry_named;
+			Blocker blocker;
+			Connection connection;
+
+			/* Streaming to a listener */
+			ProblemListener* listener;
+			bool announced;				// problem_ready() has been called
+			unsigned streamed;			// connections passed on so far
+
+			Field lookup(const JsonString& key);
+			bool at_field();
+			void begin_value();
+			void announce();
+
+		public:
+			/* Constructors/Destructors */
+			ProblemBuilder();
+			~ProblemBuilder();
+
+			/* Mutators */
+			void set_listener(ProblemListener* listener);
+			void start_route_run();
+			void append_routes(ProblemBuilder* run);
+
+			/* Accessors */
+			bool is_complete() { return this->complete; }
+			string get_name() { return this->name; }
+			unsigned int get_width() { return this->width; }
+			unsigned int get_height() { return this->height; }
+			vector<Connection>& get_connections() { return this->connections; }
+			vector<Blocker>& get_blockers() { return this->blockers; }
+			bool has_blocker_list() { return this->blocker_list; }
+			bool has_route_list() { return this->route_list; }
+			unsigned get_blocker_list_size() { return this->blocker_list_size; }
+			unsigned get_route_list_size() { return this->route_list_size; }
+			unsigned get_unnamed_blockers() { return this->unnamed_blockers; }
+			unsigned get_unnamed_connections() { return this->unnamed_connections; }
+
+			/* Parser events */
+			void start_object();
+			void end_object();
+			void start_array();
+			void end_array();
+			void start_name_value(const JsonString& name);
+			void end_name_value();
+			void string_value(const JsonString& value);
+			void int_value(int value);
+			void float_value(float value);
+			void bool_value(bool value);
+			void null_value();
+	};
+
+	bool parse_problem(string filename, ProblemBuilder* builder);
+}
+
+#endif // _PROBLEM_BUILDER_H_
@@ -0,0 +1,85 @@
+#ifndef _PROBLEM_GENERATOR_BASE_H_
+#define _PROBLEM_GENERATOR_BASE_H_
+
+#include "problem_object.h"
+#include <vector>
+#include <string>
+#include <random>
+
+using std::vector;
+using std::string;
+
+/*
+    Writes synthetic problem files for the benchmark (benchmark --generate). The same
+    options and seed always give the same file, on any machine: only std::mt19937, whose
+    output the standard fixes, is drawn from, never the library's distributions.
+
+    Blockers are added until they cover density of the grid. Their sides are drawn from
+    min_blocker to max_blocker:
+
+        kUniformSizes       both sides uniform
+        kSmallSizes         skewed towards min_blocker, a few large blockers among many small
+        kWallSizes          one or two cells thick and up to max_blocker long, which makes mazes
+
+    With clusters set the blockers are heaped around that many random centres instead of
+    being spread evenly, leaving congested regions next to open ones. Routes have their
+    source and sink on free cells, min_length to max_length apart (Manhattan distance).
+*/
+
+namespace Utilities {
+    enum BlockerSizes {
+        kUniformSizes,
+        kSmallSizes,
+        kWallSizes
+    };
+
+    struct GeneratorOptions {
+        int width;
+        int height;
+        unsigned seed;
+        double density;             // fraction of the cells blocked, at most 0.9
+        int min_blocker;
+        int max_blocker;
+        BlockerSizes sizes;
+        int clusters;               // 0 to spread blockers evenly
+        int routes;
+        int min_length;
+        int max_length;
+
+        GeneratorOptions();
+    };
+
+    class ProblemGenerator {
+        private:
+            GeneratorOptions options;
+            std::mt19937 random;
+            vector<bool> blocked;           // row major, width * height
+            vector<Blocker> blockers;
+            vector<Connection> connections;
+
+            int draw(int lo, int hi);
+            double unit();
+            int blocker_side();
+            Point blocker_corner(int width, int height, const vector<Point>& centres);
+            bool is_free(int x, int y);
+            void add_blockers();
+            void add_routes();
+
+        public:
+            /* Constructors/Destructors */
+            ProblemGenerator(const GeneratorOptions& options);
+            ~ProblemGenerator();
+
+            /* Accessors */
+            const vector<Blocker>& get_blockers() const;
+            const vector<Connection>& get_connections() const;
+
+            /* Algorithms */
+            void generate();
+            void write(string filename) const;
+
+            static BlockerSizes parse_sizes(string name);
+    };
+}
+
+#endif //_PROBLEM_GENERATOR_BASE_H_
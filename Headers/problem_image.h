@@ -0,0 +1,86 @@
+#ifndef _PROBLEM_IMAGE_BASE_H_
+#define _PROBLEM_IMAGE_BASE_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+/*
+    Layout of a compiled problem image (grid_router <test_file> --compile), which
+    ProblemObject loads instead of parsing the JSON file while the file still has the
+    size and modification time, to the nanosecond, that the image records for it.
+
+        ImageHeader
+        PackedBlocker[blocker_count]
+        PackedConnection[connection_count]
+        names                           every name back to back, no terminators
+
+    Everything is in host byte order, the byte_order field tells a foreign image
+    apart. checksum is FNV-1a (64 bit) of everything after the header. Bump
+    kImageVersion whenever the layout changes, older images are then ignored.
+*/
+
+namespace Utilities {
+    static const char kImageMagic[8] = { 'G', 'R', 'I', 'D', 'P', 'R', 'O', 'B' };
+    static const uint32_t kImageVersion = 2;
+    static const uint32_t kImageByteOrder = 0x01020304;
+
+    /* Warnings the JSON file raised when loaded, replayed when the image is loaded */
+    enum ImageFlags {
+        kImageEmptyBlockerList = 1,
+        kImageEmptyRouteList = 2
+    };
+
+    /* The JSON file an image was compiled from, as it was when it was read */
+    struct SourceStamp {
+        uint64_t size;
+        int64_t mtime_sec;
+        int64_t mtime_nsec;
+    };
+
+    struct ImageHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t header_size;
+        uint32_t flags;
+        uint32_t width;
+        uint32_t height;
+        uint32_t blocker_count;
+        uint32_t connection_count;
+        uint32_t unnamed_blockers;
+        uint32_t unnamed_connections;
+        uint32_t name_offset;           // problem name, in the name table
+        uint32_t name_length;
+        uint64_t names_size;
+        uint64_t checksum;
+        SourceStamp source;
+    };
+
+    struct PackedBlocker {
+        uint32_t name_offset;
+        uint32_t name_length;
+        int32_t x;
+        int32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct PackedConnection {
+        uint32_t name_offset;
+        uint32_t name_length;
+        int32_t source_x;
+        int32_t source_y;
+        int32_t sink_x;
+        int32_t sink_y;
+    };
+
+    /* FNV-1a, pass the previous result as hash to checksum several pieces as one */
+    static const uint64_t kImageChecksumSeed = 14695981039346656037ULL;
+    uint64_t image_checksum(const char* data, size_t size, uint64_t hash = kImageChecksumSeed);
+
+    /* False, with stamp zeroed, if filename cannot be stat'ed */
+    bool read_source_stamp(std::string filename, SourceStamp* stamp);
+}
+
+#endif //_PROBLEM_IMAGE_BASE_H_
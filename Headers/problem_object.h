@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "point.h"
+#include "problem_image.h"
 
 #include "../Utilities/JSON_parser/Headers/json_file.h"
 #include "../Utilities/JSON_parser/Headers/json_array.h"
@@ -30,6 +31,8 @@ struct Blocker {
 };
 
 namespace Utilities {
+	class ProblemBuilder;
+
 	class ProblemObject {
 		private:
 			string name;
@@ -38,24 +41,50 @@ namespace Utilities {
 			vector<Connection> connections;
 			vector<Blocker> blockers;
 
-			void add_blocker(JsonObject* blocker);
-			void add_connection(JsonObject* connection);
-			int extract_int(JsonValue* int_value);
+			/* Warnings raised while loading, kept so a compiled image can replay them */
+			bool empty_blocker_list;
+			bool empty_route_list;
+			unsigned int unnamed_blockers;
+			unsigned int unnamed_connections;
+			SourceStamp source;				// of the file the problem was loaded from, for write_image
+
+			static int extract_int(JsonValue* int_value);
+			void load_json(string filename);
+			void take(ProblemBuilder* builder);
+			bool load_image(string image_filename);
+			void report_load_warnings();
 
 		public:
 			/* Constructors */
 			ProblemObject();
 			ProblemObject(string filename);
+			explicit ProblemObject(ProblemBuilder* builder);
 
 			/* Destructor */
 			~ProblemObject();
 
-			/* Accessors */
+			/* Accessors, the lists are handed out by reference and stay owned by the ProblemObject */
 			string get_name() { return this->name; }
 			unsigned int get_height() { return this->height; }
 			unsigned int get_width() { return this->width; }
-			vector<Connection> get_connections() { return this->connections; }
-			vector<Blocker> get_blockers() { return this->blockers; }
+			const vector<Connection>& get_connections() const { return this->connections; }
+			const vector<Blocker>& get_blockers() const { return this->blockers; }
+
+			/* Hands the lists over to the caller, leaving them empty (see Map(ProblemObject&&)) */
+			vector<Connection> release_connections();
+			vector<Blocker> release_blockers();
+
+			/* Compiled images, loaded instead of the JSON file while it is unchanged since they were written */
+			static string image_filename(string filename);
+			static bool image_is_current(string filename);
+			bool write_image(string image_filename);
+
+			/* Loads several problem files at once, parsing them on up to threads threads */
+			static vector<ProblemObject*> load_batch(vector<string> filenames, unsigned threads);
+
+			/* JSON helpers, shared with other readers of blocker and route objects */
+			static Blocker read_blocker(JsonObject* blocker);
+			static Connection read_connection(JsonObject* connection);
 
 			/*
 			Note: The Problem Objects should be created by JSON problem files, because of this
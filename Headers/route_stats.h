@@ -0,0 +1,103 @@
+#ifndef _ROUTE_STATS_BASE_H_
+#define _ROUTE_STATS_BASE_H_
+
+#include "path.h"
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+using Utilities::Path;
+
+/*
+    What the search did for each connection, collected when a RouteReport is handed to
+    Map::set_report. lee and the global router (soukup, ECO, the daemon) both fill one in
+    per connection. write() emits them as JSON, or as CSV if the filename ends in .csv,
+    with the 50th, 90th and 99th percentile and the maximum of every count:
+
+    {
+        "connections": 3,
+        "outcomes": {"routed": 2, "blocked": 0, "invalid": 0, "unreachable": 1},
+        "total_ms": {"expansion": 4.1, "backtrace": 0.2, "reset": 0.9, "print": 12.5},
+        "percentiles": {
+            "expanded": {"p50": 812, "p90": 2480, "p99": 2480, "max": 2480},
+            ...
+        },
+        "routes": [
+            {"name": "route0", "outcome": "routed", "expanded": 812, "queue_peak": 61,
+                "length": 53, "bends": 48, "expansion_ms": 1.2, "backtrace_ms": 0.1,
+                "reset_ms": 0.3, "print_ms": 4.2},
+            ...
+        ]
+    }
+
+    The CSV has one row per connection followed by one row per percentile, named p50,
+    p90, p99 and max. Percentiles are over the connections that were searched (routed or
+    unreachable), and over the routed ones only for length and bends.
+*/
+
+namespace Utilities {
+    enum RouteOutcome {
+        kRouted,
+        kRouteBlocked,      // source or sink on a blocker
+        kRouteInvalid,      // out of bounds, or source and sink the same
+        kRouteUnreachable   // searched, but the sink could not be reached
+    };
+
+    /* The counts of RouteStats that percentiles are taken of */
+    enum RouteField {
+        kExpanded,
+        kQueuePeak,
+        kLength,
+        kBends,
+        kExpansionMs,
+        kBacktraceMs,
+        kResetMs,
+        kPrintMs,
+        kNumRouteFields
+    };
+
+    struct RouteStats {
+        string name;
+        RouteOutcome outcome;
+        unsigned expanded;          // cells taken off the wave queue
+        unsigned queue_peak;        // most cells waiting in the wave queue at once
+        int length;                 // of the routed path
+        unsigned bends;
+        double expansion_ms;        // expanding the wave, for soukup also the global route
+        double backtrace_ms;        // walking back from the sink and building the path
+        double reset_ms;            // lee only, clearing the grid before the search
+        double print_ms;            // lee only, printing the source, sink and map
+
+        RouteStats();
+    };
+
+    class RouteReport {
+        private:
+            vector<RouteStats> routes;
+
+            vector<double> values(RouteField field) const;
+
+        public:
+            /* Constructors/Destructors */
+            RouteReport();
+            ~RouteReport();
+
+            /* Accessors */
+            unsigned size() const;
+            const RouteStats& at(unsigned index) const;
+            unsigned count(RouteOutcome outcome) const;
+            double percentile(RouteField field, double fraction) const;
+
+            /* Mutators */
+            void add(const RouteStats& stats);
+            void clear();
+
+            void write(string filename) const;
+
+            static unsigned count_bends(const Path& path);
+            static const char* outcome_name(RouteOutcome outcome);
+    };
+}
+
+#endif //_ROUTE_STATS_BASE_H_
@@ -0,0 +1,71 @@
+/*
+    C interface to the router, built into librouter.a / librouter.so (make librouter).
+
+    Meant for flows that route many small batches in process instead of running
+    grid_router once per problem. None of these calls print anything or exit the process:
+    problems are reported through return values and per connection status codes.
+
+        router_map* map = router_map_create(width, height, blockers, num_blockers);
+        router_route_batch(map, connections, num_connections,
+                           points, points_capacity, offsets, status);
+        router_map_free(map);
+
+    A routed connection is written to points as the list of cells it visits, source
+    first and sink last. Connection i owns points[offsets[i]] .. points[offsets[i + 1] - 1],
+    so offsets must have room for num_connections + 1 entries. Connections that are not
+    routed get an empty range.
+
+    Connections of a batch are routed in order and steer around the congestion of the
+    ones before them. Every batch starts from an uncongested map, so routing the same
+    batch again gives the same routes.
+*/
+
+#ifndef _ROUTER_API_H_
+#define _ROUTER_API_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct router_map router_map;
+
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} router_blocker;
+
+typedef struct {
+    int source_x;
+    int source_y;
+    int sink_x;
+    int sink_y;
+} router_connection;
+
+typedef struct {
+    int x;
+    int y;
+} router_point;
+
+enum router_status {
+    ROUTER_OK = 0,
+    ROUTER_INVALID = 1,         /* out of bounds, on a blocker, or source == sink */
+    ROUTER_UNREACHABLE = 2,     /* no path exists between source and sink */
+    ROUTER_NO_SPACE = 3         /* the route did not fit in the remaining points buffer */
+};
+
+/* Returns NULL if the dimensions are not positive or a blocker does not fit on the map */
+router_map* router_map_create(int width, int height, const router_blocker* blockers, int num_blockers);
+
+/* Returns the number of points written, or -1 if the arguments are unusable */
+int router_route_batch(router_map* map, const router_connection* connections, int num_connections,
+                       router_point* points, int points_capacity, int* offsets, int* status);
+
+void router_map_free(router_map* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_ROUTER_API_H_
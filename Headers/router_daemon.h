@@ -0,0 +1,74 @@
+#ifndef _ROUTER_DAEMON_BASE_H_
+#define _ROUTER_DAEMON_BASE_H_
+
+#include "map.h"
+#include "path.h"
+#include "global_router.h"
+#include "compressed_path.h"
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+
+using std::vector;
+using std::string;
+using std::istream;
+using std::ostream;
+using Utilities::Map;
+using Utilities::Path;
+using Utilities::GlobalRouter;
+using Utilities::CompressedPath;
+
+/*
+    Long running router. The problem is loaded and the Map, blocker grid and global
+    router scratch are built once; requests are then answered one line at a time, with
+    exactly one response line per request:
+
+        ROUTE <name> <source_x> <source_y> <sink_x> <sink_y>
+                                    -> OK <name> <segments> <x1> <y1> <x2> <y2> ...
+        BLOCK <x> <y> <width> <height>      -> OK <cells changed> <rerouted> <failed>
+        UNBLOCK <x> <y> <width> <height>    -> OK <cells changed> <rerouted> <failed>
+        ECO <delta_file>            -> OK <added> <removed> <rerouted> <failed> <unchanged>
+        STATS                       -> OK <requests> <p50 us> <p99 us>
+        QUIT                        -> OK, closes the client (ends stdin mode)
+        SHUTDOWN                    -> OK, stops the daemon
+
+    Anything else is answered with "ERR <reason>". Routes answered by ROUTE are kept as
+    the daemon's current solution, which is what ECO requests are applied to. A ROUTE for
+    a name that is already routed replaces that route, and the congestion it added. BLOCK
+    and UNBLOCK are applied like a one blocker ECO: the routes they touch are rerouted,
+    and those whose source or sink ends up under a blocker are dropped as failed.
+*/
+
+namespace Utilities {
+    class RouterDaemon {
+        private:
+            Map* map;
+            GlobalRouter* router;
+            vector<CompressedPath> solution;    // chain coded, it holds every route answered
+            vector<double> latencies;       // microseconds per answered request
+            bool shutdown;
+
+            string route_request(istream& args);
+            string blocker_request(istream& args, bool add);
+            string eco_request(istream& args);
+            string stats_request();
+            bool fits_map(const Blocker& blocker);
+
+        public:
+            /* Constructors/Destructors */
+            RouterDaemon(Map* map);
+            ~RouterDaemon();
+
+            /* Accessors */
+            double percentile(double fraction);
+            bool is_shutdown();
+
+            /* Algorithms */
+            string handle(const string& request, bool* close);
+            void serve(istream& in, ostream& out);
+            void serve_socket(string socket_path);
+    };
+}
+
+#endif //_ROUTER_DAEMON_BASE_H_
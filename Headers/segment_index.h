@@ -0,0 +1,61 @@
+#ifndef _SEGMENT_INDEX_BASE_H_
+#define _SEGMENT_INDEX_BASE_H_
+
+#include "point.h"
+#include <set>
+
+using std::set;
+using Utilities::Point;
+
+/*
+    The cells a SegmentGroup covers, kept so that contains() and intersects() do not
+    have to go through every segment. Horizontal segments are kept by row and vertical
+    ones by column, each as a sorted set of runs: a run is the cells lo to hi of one row
+    (or column). Runs on the same row that overlap or touch are merged as they are added,
+    so the runs of a row never overlap and the one that could hold a cell is found with
+    a single binary search.
+
+        contains(point)                     O(log n)
+        intersects(segment), parallel       O(log n) for the runs on its own row or column
+        intersects(segment), across         O(log n + m), m the runs on the lines it spans
+
+    Segments are taken to be straight, which PathSegment already insists on.
+*/
+
+namespace Utilities {
+    class SegmentIndex {
+        private:
+            struct Run {
+                int line;           // the row (y) of a horizontal run, the column (x) of a vertical one
+                int lo;
+                int hi;
+
+                bool operator<(const Run& rhs) const {
+                    return line < rhs.line || (line == rhs.line && lo < rhs.lo);
+                }
+            };
+
+            set<Run> rows;          // horizontal segments, and segments of a single cell
+            set<Run> columns;       // vertical segments
+
+            static void add_run(set<Run>* runs, int line, int lo, int hi);
+            static bool covers(const set<Run>& runs, int line, int lo, int hi);
+            static bool crosses(const set<Run>& runs, int first_line, int last_line, int at);
+
+        public:
+            /* Constructors/Destructors */
+            SegmentIndex();
+            ~SegmentIndex();
+
+            /* Accessors */
+            bool contains(const Point& point) const;
+            bool intersects(Point source, Point sink) const;
+            unsigned size() const;
+
+            /* Mutators */
+            void add(Point source, Point sink);
+            void clear();
+    };
+}
+
+#endif //_SEGMENT_INDEX_BASE_H_
@@ -2,35 +2,65 @@
 #define _SEGMENT_GROUP_BASE_H_
 
 #include "pathsegment.h"
+#include "segment_index.h"
 #include <vector>
 
 using std::vector;
 using Utilities::Point;
 using Utilities::PathSegment;
 
+/*
+    The segments are stored by value, one after the other, so a group costs one
+    allocation however many segments it has, and copying or moving it copies or moves
+    that one buffer.
+
+    Segments are compacted as they are added: a segment that carries on in the same
+    direction from either end of the last one extends it instead of being appended.
+    A router that adds one unit segment per cell therefore ends up with one segment per
+    bend, and remove_segment only finds segments as they were stored after compaction.
+
+    contains() and intersects() go through every segment, unless build_index() has been
+    called. From then on the group keeps a SegmentIndex, updated by every add_segment,
+    and both are answered from it in logarithmic time. The index costs a tree node per
+    straight run, so it is worth it for groups that are queried many times, such as long
+    nets. remove_segment rebuilds it.
+*/
+
 namespace Utilities {
     class SegmentGroup {
         private:
-            vector<PathSegment*> segments;
+            vector<PathSegment> segments;
+            SegmentIndex* index;        // NULL unless build_index() was called
 
-            bool on_segment(Point p1, Point p2, Point p3);
+            bool on_segment(Point p1, Point p2, Point p3) const;
+            bool extends_last(Point source, Point sink);
+            void index_segment(Point source, Point sink);
 
         public:
             SegmentGroup();
+            SegmentGroup(const SegmentGroup& other);
+            SegmentGroup(SegmentGroup&& other);
+            SegmentGroup& operator=(const SegmentGroup& other);
+            SegmentGroup& operator=(SegmentGroup&& other);
             ~SegmentGroup();
 
             /* Accessors */
             unsigned size() const;
-            PathSegment* at(unsigned index) const;
+            const PathSegment& at(unsigned index) const;
             bool empty() const;
-            bool contains(const Point& point);
-            int get_length();
-            void print();
+            bool contains(const Point& point) const;
+            bool intersects(Point source, Point sink) const;
+            bool is_indexed() const;
+            int get_length() const;
+            void print() const;
 
             /* Mutators */
-            void add_segment(PathSegment* pathsegment);
+            void build_index();
+            void drop_index();
+            void reserve(unsigned segments);
+            void add_segment(const PathSegment& pathsegment);
             void add_segment(Point source, Point sink);
-            void remove_segment(PathSegment* pathsegment);
+            void remove_segment(const PathSegment& pathsegment);
             void remove_segment(Point soruce, Point sink);
             void remove_segment(int index);
     };
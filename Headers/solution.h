@@ -0,0 +1,169 @@
+#ifndef _SOLUTION_BASE_H_
+#define _SOLUTION_BASE_H_
+
+#include "path.h"
+#include "path_sink.h"
+#include "solution_image.h"
+#include <vector>
+#include <string>
+
+using std::vector;
+using std::string;
+using Utilities::Path;
+
+/*
+    Reading and writing of routed solutions as JSON, so a later run (ECO mode, checkers)
+    can pick a solution back up. Each route keeps its connection name, source, sink and
+    segments:
+
+    {
+        "routes": [
+        {"name": "route0", "source_x": 0, "source_y": 0, "sink_x": 2, "sink_y": 0,
+            "segments": [[0,0,1,0], [1,0,2,0]]}
+        ]
+    }
+
+    Pass "-" as the filename to write to standard out.
+
+    Both this JSON and the text grid_router prints ("Path 0: (0,0) -> (1,0) | ...") are
+    produced by SolutionWriter, which formats a whole solution into one buffer, converting
+    the coordinates itself, and hands it to the OS with a single write(). The buffer is
+    kept between calls, so a writer that is reused stops allocating once it has grown to
+    the largest solution it has written.
+
+    write_solution_image writes the same routes in a binary layout (solution_image.h)
+    that is several times smaller and is read back without parsing, by
+    SolutionImageReader. read_solution takes either kind of file.
+*/
+
+namespace Utilities {
+    class SolutionWriter {
+        private:
+            char* buffer;
+            size_t capacity;
+            size_t used;
+
+            char* make_room(size_t bytes);
+            void flush(string filename);
+
+        public:
+            SolutionWriter();
+            SolutionWriter(const SolutionWriter&) = delete;
+            SolutionWriter& operator=(const SolutionWriter&) = delete;
+            ~SolutionWriter();
+
+            /* Whole solutions */
+            void format_text(const vector<Path>& paths);
+            void format_json(const vector<Path>& paths);
+            void write_text(string filename, const vector<Path>& paths);
+            void write_json(string filename, const vector<Path>& paths);
+
+            /* One path at a time, for solutions that are written as they are routed */
+            void format_text(unsigned index, const Path& path);
+            void begin_json();
+            void format_json(const Path& path, bool first);
+            void end_json(bool any);
+            void write_to(int fd, string filename);
+
+            const char* data() const;
+            size_t size() const;
+    };
+
+    /*
+        Builds a binary solution one path at a time. Only the encoded routes and their
+        names are kept, a few bytes a segment, until write() sorts the name index and
+        writes the file.
+    */
+    class SolutionImageWriter {
+        private:
+            string names;
+            string data;
+            vector<PackedRoute> routes;
+
+        public:
+            SolutionImageWriter();
+            ~SolutionImageWriter();
+
+            void add(const Path& path);
+            unsigned size() const;
+            bool write(string filename);
+    };
+
+    /*
+        A PathSink that writes each path out as it is routed: printed to standard out in
+        the text format, and appended to the JSON and binary solutions if they were asked
+        for. Text and JSON are written whenever their buffer passes kStreamFlushSize, so
+        no more than that is held back. The JSON file is only opened when the first of it
+        is written, and JSON for standard out is held until finish(), so it does not end up
+        in the middle of the printed paths. finish() must be called once routing is done,
+        it closes the JSON and writes the binary solution.
+    */
+    static const size_t kStreamFlushSize = 1 << 16;
+
+    class SolutionStream : public PathSink {
+        private:
+            SolutionWriter text;
+            SolutionWriter json;
+            SolutionImageWriter image;
+            string json_file;
+            string binary_file;
+            int json_fd;
+            unsigned count;
+
+            void write_json(bool last);
+
+        public:
+            SolutionStream(string json_file = "", string binary_file = "");
+            SolutionStream(const SolutionStream&) = delete;
+            SolutionStream& operator=(const SolutionStream&) = delete;
+            ~SolutionStream();
+
+            void path_ready(Path& path);
+            void finish();
+            unsigned size() const;
+    };
+
+    /*
+        Reads a binary solution written by write_solution_image without loading all of
+        it. The file is mapped, next() decodes the routes one at a time in the order they
+        were written, and find() goes straight to a route by name through the sorted index,
+        so only the pages of the index and of that route are read.
+    */
+    class SolutionImageReader {
+        private:
+            const char* data;
+            size_t data_size;
+            SolutionHeader header;
+            const PackedRoute* routes;
+            const uint32_t* name_order;
+            const char* names;
+            const uint8_t* route_data;
+            unsigned next_route;
+
+            int compare_name(unsigned index, const string& name) const;
+
+        public:
+            SolutionImageReader();
+            SolutionImageReader(const SolutionImageReader&) = delete;
+            SolutionImageReader& operator=(const SolutionImageReader&) = delete;
+            ~SolutionImageReader();
+
+            static bool is_solution_image(string filename);
+
+            bool open(string filename);
+            void close();
+            bool is_open() const;
+            unsigned size() const;
+            string get_name(unsigned index) const;
+            bool read(unsigned index, Path* path) const;
+            bool find(const string& name, Path* path) const;
+            bool next(Path* path);
+            void rewind();
+    };
+
+    void write_solution(string filename, const vector<Path>& paths);
+    bool write_solution_image(string filename, const vector<Path>& paths);
+    vector<Path> read_solution(string filename);
+}
+
+#endif //_SOLUTION_BASE_H_
@@ -0,0 +1,73 @@
+#ifndef _SOLUTION_IMAGE_BASE_H_
+#define _SOLUTION_IMAGE_BASE_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+/*
+    Layout of a binary solution (grid_router ... --binary-solution <file>), which
+    SolutionImageReader reads back route by route or by connection name.
+
+        SolutionHeader
+        PackedRoute[route_count]        in the order of the solution
+        uint32_t[route_count]           route indices sorted by name, for find()
+        names                           every name back to back, no terminators
+        route data                      the segments of every route, see below
+
+    A route's data starts at its data_offset and runs to the next route's. It is all
+    varints, signed values zigzag encoded:
+
+        segment count, form
+        source x, source y              the route's source
+        sink x, sink y                  less the source
+        segments, depending on form:
+
+        kChainForwards      the end the chain starts from, less the source, then one
+                            step per segment: each segment starts where the last ended
+        kChainBackwards     the end the chain starts from, less the sink, then one step
+                            per segment: each segment ends where the last started, the
+                            way lee's backtrace builds paths
+        kChainNone          four values per segment: its source less the last segment's
+                            sink (the route's source for the first), its sink less its
+                            own source
+
+    A step is a straight segment's signed length, times two, plus 1 if it runs along y.
+    A chained segment usually costs a byte or two instead of four coordinates.
+
+    Everything except the varints is in host byte order, the byte_order field tells a
+    foreign file apart. checksum is image_checksum (FNV-1a) of the route table, the name
+    order and the names, so the index is checked when the file is opened. Route data is
+    not covered, it is bounds checked as each route is decoded, so loading one route
+    never reads the rest of the file. Bump kSolutionVersion whenever the layout changes.
+*/
+
+namespace Utilities {
+    static const char kSolutionMagic[8] = { 'G', 'R', 'I', 'D', 'S', 'O', 'L', 'N' };
+    static const uint32_t kSolutionVersion = 1;
+    static const uint32_t kSolutionByteOrder = 0x01020304;
+
+    enum SolutionChainForm {
+        kChainNone = 0,
+        kChainForwards = 1,
+        kChainBackwards = 2
+    };
+
+    struct SolutionHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t header_size;
+        uint32_t route_count;
+        uint64_t names_size;
+        uint64_t data_size;
+        uint64_t checksum;
+    };
+
+    struct PackedRoute {
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint64_t data_offset;           // from the start of the route data
+    };
+}
+
+#endif //_SOLUTION_IMAGE_BASE_H_
@@ -0,0 +1,190 @@
+#include "../Headers/map.h"
+#include "../Headers/problem_object.h"
+#include "../Headers/problem_builder.h"
+#include "../Headers/global_router.h"
+#include "../Headers/solution.h"
+#include "../Headers/problem_generator.h"
+#include "../Headers/claim.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+/*
+	Benchmark for the router (make benchmark, or make bench to generate and time a set of problems).
+
+		./benchmark --generate <problem.json> [--size <width>x<height>] [--seed <n>] [--density <fraction>]
+		            [--blocker-size <min>:<max>] [--blocker-sizes uniform|small|walls] [--clusters <n>]
+		            [--routes <n>] [--route-length <min>:<max>]
+
+		./benchmark <problem.json> [--runs <n>] [--lee] [--csv <file>] [--solution <file>]
+
+	The first form writes a synthetic problem, see Headers/problem_generator.h. The second loads and
+	routes a problem runs times (5 by default), timing every stage on its own: parse (the problem file
+	into a ProblemObject, always through the JSON parser even when a compiled image is current), map (building the nodes and edges), blockers (rasterizing the blockers onto
+	the map), route (soukup, or lee with --lee, which also prints the map for every connection) and
+	output (the JSON solution, written to /dev/null unless --solution is given). The median, minimum and
+	maximum of every stage are printed and appended to the CSV file, bench_output.csv by default, which
+	gets a header when it is new.
+*/
+
+typedef std::chrono::steady_clock bench_clock;
+
+enum Stage { kParse, kBuildMap, kRasterize, kRoute, kOutput, kTotal, kNumStages };
+static const char* kStageNames[kNumStages] = { "parse", "map", "blockers", "route", "output", "total" };
+
+static double elapsed_ms(bench_clock::time_point* start) {
+	bench_clock::time_point now = bench_clock::now();
+	double ms = std::chrono::duration<double, std::milli>(now - *start).count();
+	*start = now;
+	return ms;
+}
+
+static double median(vector<double> times) {
+	std::sort(times.begin(), times.end());
+	unsigned middle = times.size() / 2;
+	return (times.size() % 2) ? times.at(middle) : (times.at(middle - 1) + times.at(middle)) / 2;
+}
+
+static void parse_pair(string text, const char* format, int* first, int* second, string option) {
+	if(sscanf(text.c_str(), format, first, second) != 2) {
+		Utilities::claim("Could not read " + option + " " + text, Utilities::kError);
+	}
+}
+
+static int generate(int argc, char* argv[]) {
+	Utilities::GeneratorOptions options;
+	for(int i = 3; i + 1 < argc; i += 2) {
+		string option = argv[i], value = argv[i + 1];
+		if(option == "--size") { parse_pair(value, "%dx%d", &options.width, &options.height, option); }
+		else if(option == "--seed") { options.seed = strtoul(value.c_str(), NULL, 10); }
+		else if(option == "--density") { options.density = atof(value.c_str()); }
+		else if(option == "--blocker-size") { parse_pair(value, "%d:%d", &options.min_blocker, &options.max_blocker, option); }
+		else if(option == "--blocker-sizes") { options.sizes = Utilities::ProblemGenerator::parse_sizes(value); }
+		else if(option == "--clusters") { options.clusters = atoi(value.c_str()); }
+		else if(option == "--routes") { options.routes = atoi(value.c_str()); }
+		else if(option == "--route-length") { parse_pair(value, "%d:%d", &options.min_length, &options.max_length, option); }
+		else { Utilities::claim("Unknown generator option " + option, Utilities::kError); }
+	}
+
+	Utilities::ProblemGenerator generator(options);
+	generator.generate();
+	generator.write(string(argv[2]));
+	stringstream message;
+	message << "Wrote " << argv[2] << ": " << options.width << "x" << options.height << ", "
+	        << generator.get_blockers().size() << " blockers, " << generator.get_connections().size() << " routes";
+	Utilities::claim(&message, Utilities::kNote);
+	return 0;
+}
+
+int main(int argc,char* argv[]) {
+	if(argc < 2 || (string(argv[1]) == "--generate" && argc < 3)) {
+		cout << "Usage: ./benchmark <problem.json> [--runs <n>] [--lee] [--csv <file>] [--solution <file>]" << endl;
+		cout << "       ./benchmark --generate <problem.json> [generator options, see Source/benchmark.cc]" << endl;
+		exit(1);
+	}
+	if(string(argv[1]) == "--generate") {
+		return generate(argc, argv);
+	}
+
+	string problem_file = argv[1], csv_file = "bench_output.csv", solution_file = "/dev/null";
+	int runs = 5;
+	bool lee = false;
+	for(int i = 2; i < argc; i++) {
+		if(string(argv[i]) == "--lee") { lee = true; }
+		if(i + 1 == argc) { continue; }
+		if(string(argv[i]) == "--runs") { runs = atoi(argv[i + 1]); }
+		if(string(argv[i]) == "--csv") { csv_file = argv[i + 1]; }
+		if(string(argv[i]) == "--solution") { solution_file = argv[i + 1]; }
+	}
+	if(runs < 1) {
+		Utilities::claim("The benchmark needs at least one run", Utilities::kError);
+	}
+
+	vector<double> times[kNumStages];
+	int width = 0, height = 0;
+	unsigned num_blockers = 0, num_connections = 0, num_routed = 0;
+	for(int run = 0; run < runs; run++) {
+		bench_clock::time_point started = bench_clock::now(), start = started;
+		//Not ProblemObject(problem_file), which loads a current compiled image instead of parsing
+		Utilities::ProblemBuilder builder;
+		Utilities::parse_problem(problem_file, &builder);
+		if(!builder.is_complete()) {
+			Utilities::claim("The JSON parser failed because the file input has no objects", Utilities::kError);
+		}
+		Utilities::ProblemObject* problem = new Utilities::ProblemObject(&builder);
+		times[kParse].push_back(elapsed_ms(&start));
+
+		//Built without blockers, so rasterizing them is timed on its own
+		Utilities::Map* map = new Utilities::Map(problem->get_width(), problem->get_height(), vector<Blocker>());
+		times[kBuildMap].push_back(elapsed_ms(&start));
+		map->set_blockers(problem->get_blockers());
+		times[kRasterize].push_back(elapsed_ms(&start));
+
+		const vector<Connection>& connections = problem->get_connections();
+		vector<Path> paths;
+		if(lee) {
+			for(unsigned i = 0; i < connections.size(); i++) {
+				Path path;
+				if(map->lee_route(connections.at(i), i, &path)) { paths.push_back(std::move(path)); }
+			}
+		} else {
+			Utilities::GlobalRouter router(map);
+			router.set_reporting(false);
+			paths = router.route(connections);
+		}
+		times[kRoute].push_back(elapsed_ms(&start));
+
+		Utilities::write_solution(solution_file, paths);
+		times[kOutput].push_back(elapsed_ms(&start));
+		times[kTotal].push_back(elapsed_ms(&started));
+
+		width = problem->get_width();
+		height = problem->get_height();
+		num_blockers = problem->get_blockers().size();
+		num_connections = connections.size();
+		num_routed = 0;
+		for(unsigned i = 0; i < paths.size(); i++) {
+			if(paths.at(i).size() > 0) { num_routed++; }
+		}
+		delete map;
+		delete problem;
+	}
+
+	std::ifstream existing(csv_file.c_str());
+	bool fresh = !existing.good() || existing.peek() == EOF;
+	existing.close();
+	std::ofstream csv(csv_file.c_str(), std::ios::app);
+	if(!csv.is_open()) {
+		Utilities::claim("Unable to open benchmark file " + csv_file + " for writing", Utilities::kError);
+	}
+	if(fresh) {
+		csv << "problem,width,height,blockers,connections,routed,algorithm,runs,stage,median_ms,min_ms,max_ms,spread_pct\n";
+	}
+
+	cout << problem_file << ": " << width << "x" << height << ", " << num_blockers << " blockers, " << num_routed
+	     << " of " << num_connections << " connections routed with " << (lee ? "lee" : "soukup") << ", "
+	     << runs << " runs" << endl;
+	for(int stage = 0; stage < kNumStages; stage++) {
+		double middle = median(times[stage]);
+		double lowest = *std::min_element(times[stage].begin(), times[stage].end());
+		double highest = *std::max_element(times[stage].begin(), times[stage].end());
+		double spread = (middle > 0) ? 100.0 * (highest - lowest) / middle : 0.0;
+		csv << problem_file << "," << width << "," << height << "," << num_blockers << ","
+		    << num_connections << "," << num_routed << "," << (lee ? "lee" : "soukup") << "," << runs << ","
+		    << kStageNames[stage] << "," << middle << "," << lowest << "," << highest << "," << spread << "\n";
+		printf("    %-9s median %10.3f ms  (%.3f - %.3f, spread %.1f%%)\n", kStageNames[stage], middle, lowest,
+		       highest, spread);
+	}
+	return 0;
+}
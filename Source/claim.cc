@@ -14,12 +14,35 @@ string Utilities::bool_to_string(bool to_convert) {
     return "false";
 }
 
-//returns the string to_quote surrounded by quotes, unless the string is "null" 
+//returns the string to_quote as a JSON string, escaped and surrounded by quotes, unless the string is "null"
 string Utilities::quote_string(string to_quote) {
     if (to_quote == "null") {
         return to_quote;
     }
-    return "\""+to_quote+"\"";
+    string quoted = "\"";
+    quoted.reserve(to_quote.size() + 2);
+    for (unsigned i = 0; i < to_quote.size(); i++) {
+        unsigned char c = to_quote[i];
+        switch (c) {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\b': quoted += "\\b"; break;
+            case '\f': quoted += "\\f"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    const char* hex = "0123456789abcdef";
+                    quoted += "\\u00";
+                    quoted += hex[c >> 4];
+                    quoted += hex[c & 15];
+                } else {
+                    quoted += c;
+                }
+        }
+    }
+    return quoted + "\"";
 }
 
 void Utilities::wait_claim(string message,int tabs) {
@@ -120,7 +143,7 @@ void Utilities::claim(stringstream* message,Severity level,int tabs) {
         case kDebug:
             if(DEBUG) {
                 for(int i = 0; i < tabs; i++) { cout << '\t'; }
-                cout << severity_level << message << endl;
+                cout << severity_level << message->str() << endl;
             }
             break;
         case kNote:
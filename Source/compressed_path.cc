@@ -0,0 +1,209 @@
+#include "../Headers/compressed_path.h"
+
+#include <algorithm>
+
+static const int kDx[4] = { 1, 0, -1, 0 };
+static const int kDy[4] = { 0, 1, 0, -1 };
+static const int kMaxRun = 64;             // steps one run byte can hold
+
+static inline int run_direction(uint8_t run) {
+    return run & 3;
+}
+
+static inline int run_steps(uint8_t run) {
+    return (run >> 2) + 1;
+}
+
+static int direction_of(Point source, Point sink) {
+    if (sink.x > source.x) { return 0; }
+    if (sink.y > source.y) { return 1; }
+    if (sink.x < source.x) { return 2; }
+    return 3;
+}
+
+Utilities::CompressedPath::CompressedPath() {
+    this->length = 0;
+    this->segments = 0;
+}
+
+Utilities::CompressedPath::~CompressedPath() {
+    /* Empty Destructor */
+}
+
+void Utilities::CompressedPath::add_run(int direction, int steps) {
+    this->length += steps;
+    while (steps > 0) {
+        int run = std::min(steps, kMaxRun);
+        this->runs.push_back((uint8_t)(direction | ((run - 1) << 2)));
+        steps -= run;
+    }
+}
+
+string Utilities::CompressedPath::get_name() const {
+    return this->name;
+}
+
+Point Utilities::CompressedPath::get_source() const {
+    return this->source;
+}
+
+Point Utilities::CompressedPath::get_sink() const {
+    return this->sink;
+}
+
+/* Number of straight segments, the same count a compacted Path of the route has */
+unsigned Utilities::CompressedPath::size() const {
+    return this->segments;
+}
+
+bool Utilities::CompressedPath::empty() const {
+    return this->runs.empty();
+}
+
+/* Checks the point against each run's extent in turn, without building any segments */
+bool Utilities::CompressedPath::contains(const Point& point) const {
+    Point at = this->start;
+    for (unsigned i = 0; i < this->runs.size(); i++) {
+        int direction = run_direction(this->runs[i]), steps = run_steps(this->runs[i]);
+        Point next(at.x + kDx[direction] * steps, at.y + kDy[direction] * steps);
+        if (point.x >= std::min(at.x, next.x) && point.x <= std::max(at.x, next.x) &&
+                point.y >= std::min(at.y, next.y) && point.y <= std::max(at.y, next.y)) {
+            return true;
+        }
+        at = next;
+    }
+    return false;
+}
+
+int Utilities::CompressedPath::get_length() const {
+    return this->length;
+}
+
+/* Bytes of chain code, not counting the fixed size of the object */
+unsigned Utilities::CompressedPath::encoded_size() const {
+    return this->runs.size();
+}
+
+Utilities::CompressedPath::const_iterator Utilities::CompressedPath::begin() const {
+    return const_iterator(this, 0, this->start);
+}
+
+Utilities::CompressedPath::const_iterator Utilities::CompressedPath::end() const {
+    return const_iterator(this, this->runs.size(), Point());
+}
+
+/*
+
+    Parameter path (const Path&): The path to encode, its segments must form one chain.
+    Paths built from source to sink and paths built backwards from the sink, the way
+    lee's backtrace builds them, are both accepted, the encoding always runs forwards.
+
+    Return bool: False if the segments are not one chain, the path is then left with
+    its name and end points but no runs, like a connection that was not routed
+
+*/
+bool Utilities::CompressedPath::encode(const Path& path) {
+    this->name = path.get_name();
+    this->source = path.get_source();
+    this->sink = path.get_sink();
+    this->start = Point();
+    this->runs.clear();
+    this->length = 0;
+    this->segments = 0;
+    unsigned count = path.size();
+    if (count == 0) {
+        return true;
+    }
+    bool backwards = count > 1 && !(path.at(0).get_sink() == path.at(1).get_source());
+
+    unsigned bytes = 0;
+    for (unsigned i = 0; i < count; i++) {
+        bytes += (path.at(i).get_length() + kMaxRun - 1) / kMaxRun;
+    }
+    this->runs.reserve(bytes);
+
+    Point at = path.at(backwards ? count - 1 : 0).get_source();
+    this->start = at;
+    int last_direction = -1;
+    for (unsigned i = 0; i < count; i++) {
+        const PathSegment& segment = path.at(backwards ? count - 1 - i : i);
+        if (!(segment.get_source() == at)) {
+            this->runs.clear();
+            this->length = 0;
+            this->segments = 0;
+            return false;
+        }
+        if (segment.get_length() == 0) {
+            continue;
+        }
+        int direction = direction_of(segment.get_source(), segment.get_sink());
+        if (direction != last_direction) {
+            this->segments++;
+            last_direction = direction;
+        }
+        this->add_run(direction, segment.get_length());
+        at = segment.get_sink();
+    }
+    return true;
+}
+
+/*
+
+    Return Path: The route as an ordinary Path, one segment per straight run, from the
+    start of the chain to its end.
+
+*/
+Path Utilities::CompressedPath::expand() const {
+    Path path;
+    path.set_name(this->name);
+    path.set_source(this->source);
+    path.set_sink(this->sink);
+    path.reserve(this->segments);
+    for (const_iterator it = this->begin(); it != this->end(); ++it) {
+        path.add_segment(*it);
+    }
+    return path;
+}
+
+Utilities::CompressedPath::const_iterator::const_iterator(const CompressedPath* path, unsigned run, Point head):
+        head(head),tail(head) {
+    this->path = path;
+    this->run = run;
+    this->next_run = run;
+    this->load();
+}
+
+/* Finds where the segment starting at run ends, the runs after it in the same direction belong to it too */
+void Utilities::CompressedPath::const_iterator::load() {
+    const vector<uint8_t>& runs = this->path->runs;
+    this->tail = this->head;
+    this->next_run = this->run;
+    if (this->run >= runs.size()) {
+        return;
+    }
+    int direction = run_direction(runs[this->run]);
+    while (this->next_run < runs.size() && run_direction(runs[this->next_run]) == direction) {
+        int steps = run_steps(runs[this->next_run]);
+        this->tail = Point(this->tail.x + kDx[direction] * steps, this->tail.y + kDy[direction] * steps);
+        this->next_run++;
+    }
+}
+
+PathSegment Utilities::CompressedPath::const_iterator::operator*() const {
+    return PathSegment(this->head, this->tail);
+}
+
+Utilities::CompressedPath::const_iterator& Utilities::CompressedPath::const_iterator::operator++() {
+    this->head = this->tail;
+    this->run = this->next_run;
+    this->load();
+    return *this;
+}
+
+bool Utilities::CompressedPath::const_iterator::operator==(const const_iterator& rhs) const {
+    return this->path == rhs.path && this->run == rhs.run;
+}
+
+bool Utilities::CompressedPath::const_iterator::operator!=(const const_iterator& rhs) const {
+    return !(*this == rhs);
+}
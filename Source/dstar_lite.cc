@@ -0,0 +1,211 @@
+#include "../Headers/dstar_lite.h"
+#include "../Headers/claim.h"
+
+#include <climits>
+#include <cstdlib>
+
+static const int kInfinity = INT_MAX / 4;
+static const int kDx[4] = { 1, -1, 0, 0 };
+static const int kDy[4] = { 0, 0, 1, -1 };
+
+Utilities::DStarLite::DStarLite(Map* map, Point source, Point sink):source(source),sink(sink) {
+    this->map = map;
+    this->width = map->get_width();
+    this->height = map->get_height();
+    this->expansions = 0;
+    int cells = this->width * this->height;
+    this->g.assign(cells, kInfinity);
+    this->rhs.assign(cells, kInfinity);
+    this->queued_key.assign(cells, DStarKey(0, 0));
+    this->in_queue.assign(cells, false);
+
+    int goal = this->index(sink.x, sink.y);
+    this->rhs.at(goal) = 0;
+    this->queue_insert(goal);
+}
+
+Utilities::DStarLite::~DStarLite() {
+    /* Empty Destructor */
+}
+
+Point Utilities::DStarLite::get_source() {
+    return this->source;
+}
+
+Point Utilities::DStarLite::get_sink() {
+    return this->sink;
+}
+
+int Utilities::DStarLite::get_expansions() {
+    return this->expansions;
+}
+
+// Length of the current shortest path, or -1 if the sink cannot be reached
+int Utilities::DStarLite::get_distance() {
+    int start = this->index(this->source.x, this->source.y);
+    return (this->g.at(start) >= kInfinity) ? -1 : this->g.at(start);
+}
+
+int Utilities::DStarLite::index(int x, int y) {
+    return y * this->width + x;
+}
+
+// Manhattan distance from the source, the search runs from the sink towards it
+int Utilities::DStarLite::heuristic(int cell) {
+    return abs(cell % this->width - this->source.x) + abs(cell / this->width - this->source.y);
+}
+
+int Utilities::DStarLite::edge_cost(int from, int to) {
+    if (this->map->is_blocked(from % this->width, from / this->width) ||
+            this->map->is_blocked(to % this->width, to / this->width)) {
+        return kInfinity;
+    }
+    return 1;
+}
+
+Utilities::DStarKey Utilities::DStarLite::calculate_key(int cell) {
+    int best = std::min(this->g.at(cell), this->rhs.at(cell));
+    if (best >= kInfinity) {
+        return DStarKey(kInfinity, kInfinity);
+    }
+    return DStarKey(best + this->heuristic(cell), best);
+}
+
+void Utilities::DStarLite::queue_remove(int cell) {
+    if (this->in_queue.at(cell)) {
+        this->open.erase(pair<DStarKey, int>(this->queued_key.at(cell), cell));
+        this->in_queue.at(cell) = false;
+    }
+}
+
+void Utilities::DStarLite::queue_insert(int cell) {
+    this->queued_key.at(cell) = this->calculate_key(cell);
+    this->open.insert(pair<DStarKey, int>(this->queued_key.at(cell), cell));
+    this->in_queue.at(cell) = true;
+}
+
+/*
+
+    Parameter cell (int): The cell whose one step lookahead (rhs) may have changed
+
+    Recomputes rhs from the cell's neighbours and puts the cell on the open list if, and
+    only if, it is now inconsistent (g != rhs).
+
+*/
+void Utilities::DStarLite::update_vertex(int cell) {
+    if (cell != this->index(this->sink.x, this->sink.y)) {
+        int best = kInfinity;
+        int x = cell % this->width, y = cell / this->width;
+        for (int d = 0; d < 4; d++) {
+            int next_x = x + kDx[d], next_y = y + kDy[d];
+            if (next_x < 0 || next_x >= this->width || next_y < 0 || next_y >= this->height) { continue; }
+            int next = this->index(next_x, next_y);
+            int cost = this->edge_cost(cell, next);
+            if (cost >= kInfinity || this->g.at(next) >= kInfinity) { continue; }
+            best = std::min(best, cost + this->g.at(next));
+        }
+        this->rhs.at(cell) = best;
+    }
+    this->queue_remove(cell);
+    if (this->g.at(cell) != this->rhs.at(cell)) {
+        this->queue_insert(cell);
+    }
+}
+
+/*
+
+    Return bool: Whether the source can reach the sink. Expands inconsistent cells until
+    the source is consistent and nothing on the open list could still improve it.
+
+*/
+bool Utilities::DStarLite::compute_shortest_path() {
+    int start = this->index(this->source.x, this->source.y);
+    this->expansions = 0;
+    while (!this->open.empty() &&
+            (this->open.begin()->first < this->calculate_key(start) || this->rhs.at(start) != this->g.at(start))) {
+        DStarKey old_key = this->open.begin()->first;
+        int cell = this->open.begin()->second;
+        DStarKey new_key = this->calculate_key(cell);
+        this->expansions++;
+        if (old_key < new_key) {
+            this->queue_remove(cell);
+            this->queue_insert(cell);
+            continue;
+        }
+
+        int x = cell % this->width, y = cell / this->width;
+        if (this->g.at(cell) > this->rhs.at(cell)) {
+            this->g.at(cell) = this->rhs.at(cell);
+            this->queue_remove(cell);
+        } else {
+            this->g.at(cell) = kInfinity;
+            this->update_vertex(cell);
+        }
+        for (int d = 0; d < 4; d++) {
+            int next_x = x + kDx[d], next_y = y + kDy[d];
+            if (next_x < 0 || next_x >= this->width || next_y < 0 || next_y >= this->height) { continue; }
+            this->update_vertex(this->index(next_x, next_y));
+        }
+    }
+    return this->g.at(start) < kInfinity;
+}
+
+/*
+
+    Parameter changed (vector<Point>): Cells of the Map that flipped between free and blocked
+
+    Every edge touching a changed cell changed cost, so the cell and its neighbours get
+    their lookahead recomputed. Call compute_shortest_path() afterwards to repair.
+
+*/
+void Utilities::DStarLite::update_cells(const vector<Point>& changed) {
+    for (unsigned i = 0; i < changed.size(); i++) {
+        int x = changed.at(i).x, y = changed.at(i).y;
+        if (x < 0 || x >= this->width || y < 0 || y >= this->height) { continue; }
+        this->update_vertex(this->index(x, y));
+        for (int d = 0; d < 4; d++) {
+            int next_x = x + kDx[d], next_y = y + kDy[d];
+            if (next_x < 0 || next_x >= this->width || next_y < 0 || next_y >= this->height) { continue; }
+            this->update_vertex(this->index(next_x, next_y));
+        }
+    }
+}
+
+/*
+
+    Return Path: The current shortest path from source to sink, made of unit segments,
+    or an empty Path if the sink is unreachable.
+
+*/
+Path Utilities::DStarLite::get_path() {
+    Path path;
+    path.set_source(this->source);
+    path.set_sink(this->sink);
+    int current = this->index(this->source.x, this->source.y);
+    int goal = this->index(this->sink.x, this->sink.y);
+    if (this->g.at(current) >= kInfinity) {
+        return path;
+    }
+    while (current != goal) {
+        int x = current % this->width, y = current / this->width;
+        int best = -1, best_cost = kInfinity;
+        for (int d = 0; d < 4; d++) {
+            int next_x = x + kDx[d], next_y = y + kDy[d];
+            if (next_x < 0 || next_x >= this->width || next_y < 0 || next_y >= this->height) { continue; }
+            int next = this->index(next_x, next_y);
+            int cost = this->edge_cost(current, next);
+            if (cost >= kInfinity || this->g.at(next) >= kInfinity) { continue; }
+            if (cost + this->g.at(next) < best_cost) {
+                best_cost = cost + this->g.at(next);
+                best = next;
+            }
+        }
+        if (best == -1) {
+            claim("D* Lite path extraction hit a dead end, search state is inconsistent", kWarning);
+            break;
+        }
+        path.add_segment(Point(x, y), Point(best % this->width, best / this->width));
+        current = best;
+    }
+    return path;
+}
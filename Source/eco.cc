@@ -0,0 +1,326 @@
+#include "../Headers/eco.h"
+#include "../Headers/claim.h"
+
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <algorithm>
+
+using std::ostream;
+using std::ofstream;
+using std::cout;
+using std::endl;
+using std::set;
+
+Utilities::EcoDelta::EcoDelta() {
+    /* Empty Constructor */
+}
+
+Utilities::EcoDelta::EcoDelta(string filename) {
+    if (!this->load(filename)) {
+        claim("The ECO delta " + filename + " has no objects, it is missing or malformed", kError);
+    }
+}
+
+/*
+
+    Parameter filename (string): The delta file to read, its lists are added to the ones
+                                 already loaded
+
+    Return bool: False if the file is missing or has no object, for callers such as the
+    daemon that have to keep running when a delta cannot be read
+
+*/
+bool Utilities::EcoDelta::load(string filename) {
+    JSON::JsonFile* json_file = new JSON::JsonFile();
+    json_parse(filename, json_file);
+    if (json_file->objects_size() < 1) {
+        delete json_file;
+        return false;
+    }
+    JSON::JsonObject* file_object = json_file->objects_at(0);
+
+    JsonValue* list = file_object->find("addBlockerList");
+    if (list && list->is_array()) {
+        for (unsigned i = 0; i < list->get_array()->size(); i++) {
+            JsonValue* current_value = list->get_array()->at(i);
+            if (current_value->is_object()) {
+                this->added_blockers.push_back(ProblemObject::read_blocker(current_value->get_object()));
+            }
+        }
+    }
+    list = file_object->find("removeBlockerList");
+    if (list && list->is_array()) {
+        for (unsigned i = 0; i < list->get_array()->size(); i++) {
+            JsonValue* current_value = list->get_array()->at(i);
+            if (current_value->is_object()) {
+                this->removed_blockers.push_back(ProblemObject::read_blocker(current_value->get_object()));
+            }
+        }
+    }
+    list = file_object->find("addRouteList");
+    if (list && list->is_array()) {
+        for (unsigned i = 0; i < list->get_array()->size(); i++) {
+            JsonValue* current_value = list->get_array()->at(i);
+            if (current_value->is_object()) {
+                this->added_routes.push_back(ProblemObject::read_connection(current_value->get_object()));
+            }
+        }
+    }
+    list = file_object->find("removeRouteList");
+    if (list && list->is_array()) {
+        for (unsigned i = 0; i < list->get_array()->size(); i++) {
+            JsonValue* current_value = list->get_array()->at(i);
+            JsonValue* route_name = current_value->is_object() ? current_value->get_object()->find("name") : NULL;
+            if (route_name && route_name->is_string()) {
+                this->removed_routes.push_back(route_name->get_string());
+            } else {
+                claim("Route to remove does not have a name, likely malformed JSON file", kWarning);
+            }
+        }
+    }
+    delete json_file;
+    return true;
+}
+
+// For deltas that are not read from a file, e.g. the daemon's BLOCK and UNBLOCK requests
+void Utilities::EcoDelta::add_blocker(const Blocker& blocker) {
+    this->added_blockers.push_back(blocker);
+}
+
+void Utilities::EcoDelta::remove_blocker(const Blocker& blocker) {
+    this->removed_blockers.push_back(blocker);
+}
+
+Utilities::EcoDelta::~EcoDelta() {
+    /* Empty Destructor */
+}
+
+/*
+
+    Parameter map (Map*): The routed map, the delta's blockers are applied to it
+              router (GlobalRouter*): A router built on map whose usage is that of the
+                                      previous solution, e.g. the daemon's, which apply()
+                                      keeps up to date. Without one apply() builds its own.
+
+*/
+Utilities::EcoRouter::EcoRouter(Map* map, GlobalRouter* router) {
+    this->map = map;
+    this->router = router;
+    this->reporting = true;
+}
+
+Utilities::EcoRouter::~EcoRouter() {
+    /* Empty Destructor */
+}
+
+vector<Utilities::DirtyRect> Utilities::EcoRouter::get_dirty() {
+    return this->dirty;
+}
+
+vector<Point> Utilities::EcoRouter::get_changed() {
+    return this->changed;
+}
+
+/* Passed on to the GlobalRouter apply() builds, off when stdout carries something else */
+void Utilities::EcoRouter::set_reporting(bool reporting) {
+    this->reporting = reporting;
+}
+
+// A changed blocker dirties its own cells plus a one cell ring, which catches routes hugging its edge
+void Utilities::EcoRouter::mark_dirty(Blocker changed) {
+    DirtyRect rect;
+    rect.x1 = std::max(0, changed.location.x - 1);
+    rect.y1 = std::max(0, changed.location.y - 1);
+    rect.x2 = std::min(this->map->get_width() - 1, (int)(changed.location.x + changed.width));
+    rect.y2 = std::min(this->map->get_height() - 1, (int)(changed.location.y + changed.height));
+    this->dirty.push_back(rect);
+}
+
+bool Utilities::EcoRouter::crosses_dirty(Point source, Point sink) {
+    int x1 = std::min(source.x, sink.x), x2 = std::max(source.x, sink.x);
+    int y1 = std::min(source.y, sink.y), y2 = std::max(source.y, sink.y);
+    for (unsigned j = 0; j < this->dirty.size(); j++) {
+        DirtyRect& rect = this->dirty.at(j);
+        if (x1 <= rect.x2 && x2 >= rect.x1 && y1 <= rect.y2 && y2 >= rect.y1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Utilities::EcoRouter::crosses_dirty(const Path& path) {
+    for (unsigned i = 0; i < path.size(); i++) {
+        if (this->crosses_dirty(path.at(i).get_source(), path.at(i).get_sink())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Checked a segment at a time off the chain code, without expanding the path */
+bool Utilities::EcoRouter::crosses_dirty(const CompressedPath& path) {
+    for (CompressedPath::const_iterator it = path.begin(); it != path.end(); ++it) {
+        PathSegment segment = *it;
+        if (this->crosses_dirty(segment.get_source(), segment.get_sink())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// How update() keeps a rerouted path, in the form the solution holds its paths in
+static void store(Path& routed, vector<Path>* solution) {
+    solution->push_back(std::move(routed));
+}
+
+static void store(Path& routed, vector<CompressedPath>* solution) {
+    CompressedPath compressed;
+    if (!compressed.encode(routed)) {
+        Utilities::claim("Path " + routed.get_name() + " is not a single chain of segments, it is kept unrouted",
+                         Utilities::kWarning);
+    }
+    solution->push_back(std::move(compressed));
+}
+
+/*
+
+    Parameter previous (vector<Path>): The previous solution, its paths are moved on, they
+                                        can be kept as Paths or as CompressedPaths
+              delta (EcoDelta*): The blocker and route changes to apply
+              diff (EcoDiff*): Filled in with what happened to every route
+
+    Return vector<Path>: The full updated solution, kept the same way as previous. Routes
+    that neither cross a dirty rectangle nor were touched by the delta are carried over
+    untouched (moved, not copied), everything else is rerouted with the global router on
+    the updated map, after the usage of the route it replaces has been given back.
+
+*/
+template <typename StoredPath>
+vector<StoredPath> Utilities::EcoRouter::update(vector<StoredPath> previous, EcoDelta* delta, EcoDiff* diff) {
+    diff->added.clear();
+    diff->removed.clear();
+    diff->rerouted.clear();
+    diff->failed.clear();
+    diff->unchanged = 0;
+    this->dirty.clear();
+    this->changed.clear();
+
+    vector<Blocker> blockers = delta->get_removed_blockers();
+    for (unsigned i = 0; i < blockers.size(); i++) {
+        vector<Point> flipped = this->map->remove_blocker(blockers.at(i));
+        if (!flipped.empty()) {
+            this->mark_dirty(blockers.at(i));
+            this->changed.insert(this->changed.end(), flipped.begin(), flipped.end());
+        }
+    }
+    bool freed_cells = !this->dirty.empty();
+    blockers = delta->get_added_blockers();
+    for (unsigned i = 0; i < blockers.size(); i++) {
+        vector<Point> flipped = this->map->add_blocker(blockers.at(i));
+        if (!flipped.empty()) {
+            this->mark_dirty(blockers.at(i));
+            this->changed.insert(this->changed.end(), flipped.begin(), flipped.end());
+        }
+    }
+
+    set<string> removed;
+    vector<string> removed_routes = delta->get_removed_routes();
+    vector<Connection> added_routes = delta->get_added_routes();
+    removed.insert(removed_routes.begin(), removed_routes.end());
+    for (unsigned i = 0; i < added_routes.size(); i++) {
+        removed.insert(added_routes.at(i).name);     // an added route replaces one of the same name
+    }
+
+    GlobalRouter* router = this->router;
+    if (router == NULL) {
+        // Built on the updated map, with the previous solution's usage
+        router = new GlobalRouter(this->map);
+        router->set_reporting(this->reporting);
+        for (unsigned i = 0; i < previous.size(); i++) {
+            router->charge(previous.at(i));
+        }
+    } else {
+        router->update_cells(this->changed);
+    }
+    vector<StoredPath> solution;
+    solution.reserve(previous.size() + added_routes.size());
+    for (unsigned i = 0; i < previous.size(); i++) {
+        StoredPath& path = previous.at(i);
+        if (removed.count(path.get_name())) {
+            router->release(path);
+            if (std::find(removed_routes.begin(), removed_routes.end(), path.get_name()) != removed_routes.end()) {
+                diff->removed.push_back(path.get_name());
+            }
+            continue;
+        }
+        // Previously unroutable connections get another try once blockers have been removed
+        bool unrouted = path.empty() && freed_cells;
+        if (!unrouted && !this->crosses_dirty(path)) {
+            solution.push_back(std::move(path));
+            diff->unchanged++;
+            continue;
+        }
+        Connection connection;
+        connection.name = path.get_name();
+        connection.source = path.get_source();
+        connection.sink = path.get_sink();
+        router->release(path);
+        Path rerouted;
+        if (!router->route(connection, &rerouted)) {
+            diff->failed.push_back(connection.name);
+            continue;
+        }
+        store(rerouted, &solution);
+        diff->rerouted.push_back(connection.name);
+    }
+
+    for (unsigned i = 0; i < added_routes.size(); i++) {
+        Path added;
+        if (!router->route(added_routes.at(i), &added)) {
+            diff->failed.push_back(added_routes.at(i).name);
+            continue;
+        }
+        store(added, &solution);
+        diff->added.push_back(added_routes.at(i).name);
+    }
+    if (router != this->router) {
+        delete router;
+    }
+    return solution;
+}
+
+/* A solution kept as Paths, e.g. one read back with read_solution */
+vector<Path> Utilities::EcoRouter::apply(vector<Path> previous, EcoDelta* delta, EcoDiff* diff) {
+    return this->update(std::move(previous), delta, diff);
+}
+
+/* A solution kept chain coded, e.g. the daemon's, only the paths that are rerouted are expanded */
+vector<CompressedPath> Utilities::EcoRouter::apply(vector<CompressedPath> previous, EcoDelta* delta, EcoDiff* diff) {
+    return this->update(std::move(previous), delta, diff);
+}
+
+static void write_name_list(ostream& out, string key, const vector<string>& names) {
+    out << "\t\"" << key << "\": [";
+    for (unsigned i = 0; i < names.size(); i++) {
+        out << (i ? ", " : "") << Utilities::quote_string(names.at(i));
+    }
+    out << "]," << endl;
+}
+
+void Utilities::write_eco_diff(string filename, const EcoDiff& diff) {
+    ofstream file;
+    if (filename != "-") {
+        file.open(filename.c_str());
+        if (!file.is_open()) {
+            claim("Unable to open ECO diff file " + filename + " for writing", kError);
+        }
+    }
+    ostream& out = (filename == "-") ? cout : file;
+    out << "{" << endl;
+    write_name_list(out, "added", diff.added);
+    write_name_list(out, "removed", diff.removed);
+    write_name_list(out, "rerouted", diff.rerouted);
+    write_name_list(out, "failed", diff.failed);
+    out << "\t\"unchanged\": " << diff.unchanged << endl << "}" << endl;
+}
@@ -0,0 +1,461 @@
+#include "../Headers/global_router.h"
+#include "../Headers/claim.h"
+
+#include <queue>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+using std::pair;
+using std::priority_queue;
+using std::greater;
+
+static const int kDx[4] = { 1, -1, 0, 0 };
+static const int kDy[4] = { 0, 0, 1, -1 };
+
+Utilities::GlobalRouter::GlobalRouter(Map* map, int tile_size) {
+    if (tile_size < 1) {
+        claim("GlobalRouter tile size must be at least one cell", kError);
+    }
+    this->map = map;
+    this->tile_size = tile_size;
+    this->reporting = true;
+    this->tiles_x = (map->get_width() + tile_size - 1) / tile_size;
+    this->tiles_y = (map->get_height() + tile_size - 1) / tile_size;
+    this->corridor_slot.assign(this->tiles_x * this->tiles_y, -1);
+    this->build_gcells();
+}
+
+Utilities::GlobalRouter::~GlobalRouter() {
+    /* Empty Destructor */
+}
+
+int Utilities::GlobalRouter::get_tile_size() {
+    return this->tile_size;
+}
+
+int Utilities::GlobalRouter::get_tiles_x() {
+    return this->tiles_x;
+}
+
+int Utilities::GlobalRouter::get_tiles_y() {
+    return this->tiles_y;
+}
+
+Utilities::GCell Utilities::GlobalRouter::get_gcell(int tile_x, int tile_y) {
+    if (tile_x < 0 || tile_x >= this->tiles_x || tile_y < 0 || tile_y >= this->tiles_y) {
+        claim("Attempting to access a GCell outside of the global grid's range", kError);
+    }
+    return this->gcells.at(tile_y * this->tiles_x + tile_x);
+}
+
+void Utilities::GlobalRouter::reset_usage() {
+    for (unsigned i = 0; i < this->gcells.size(); i++) {
+        this->gcells.at(i).usage = 0;
+    }
+}
+
+void Utilities::GlobalRouter::set_reporting(bool reporting) {
+    this->reporting = reporting;
+}
+
+/*
+
+    Parameter segment (const PathSegment&): One straight segment of a routed path
+              last_tile (int): The tile the path was on before the segment
+              amount (int): Added to the usage of every other tile the segment enters
+
+    Return int: The tile the segment ends on. A path is counted once per tile however
+    often it enters it, as long as it does not leave and come back.
+
+*/
+int Utilities::GlobalRouter::add_usage(const PathSegment& segment, int last_tile, int amount) {
+    // Segments are compacted, so step along each one a cell at a time
+    Point cell = segment.get_source(), end = segment.get_sink();
+    int step_x = (end.x > cell.x) - (end.x < cell.x), step_y = (end.y > cell.y) - (end.y < cell.y);
+    while (!(cell == end)) {
+        cell = Point(cell.x + step_x, cell.y + step_y);
+        int tile = this->tile_index(cell.x, cell.y);
+        if (tile != last_tile) {
+            this->gcells.at(tile).usage += amount;
+            last_tile = tile;
+        }
+    }
+    return last_tile;
+}
+
+/* Adds amount to the usage of every tile path crosses */
+void Utilities::GlobalRouter::add_usage(const Path& path, int amount) {
+    if (path.empty()) {
+        return;
+    }
+    int last_tile = this->tile_index(path.at(0).get_source().x, path.at(0).get_source().y);
+    this->gcells.at(last_tile).usage += amount;
+    for (unsigned i = 0; i < path.size(); i++) {
+        last_tile = this->add_usage(path.at(i), last_tile, amount);
+    }
+}
+
+/* As above, one segment at a time off the chain code */
+void Utilities::GlobalRouter::add_usage(const CompressedPath& path, int amount) {
+    if (path.empty()) {
+        return;
+    }
+    CompressedPath::const_iterator it = path.begin();
+    Point start = (*it).get_source();
+    int last_tile = this->tile_index(start.x, start.y);
+    this->gcells.at(last_tile).usage += amount;
+    for (; it != path.end(); ++it) {
+        last_tile = this->add_usage(*it, last_tile, amount);
+    }
+}
+
+/* Charges a path that was routed elsewhere, or given back with release(), to its tiles */
+void Utilities::GlobalRouter::charge(const Path& path) {
+    this->add_usage(path, 1);
+}
+
+void Utilities::GlobalRouter::charge(const CompressedPath& path) {
+    this->add_usage(path, 1);
+}
+
+/* Gives back the usage route() charged for path, e.g. before the path is replaced */
+void Utilities::GlobalRouter::release(const Path& path) {
+    this->add_usage(path, -1);
+}
+
+void Utilities::GlobalRouter::release(const CompressedPath& path) {
+    this->add_usage(path, -1);
+}
+
+/*
+
+    Parameter changed (vector<Point>): Cells that flipped between free and blocked since
+                                       the GCells were built, e.g. from Map::add_blocker
+
+    Keeps the tile capacities in step with the map without recounting every cell.
+
+*/
+void Utilities::GlobalRouter::update_cells(const vector<Point>& changed) {
+    for (unsigned i = 0; i < changed.size(); i++) {
+        GCell& gcell = this->gcells.at(this->tile_index(changed.at(i).x, changed.at(i).y));
+        gcell.free_cells += this->map->is_blocked(changed.at(i).x, changed.at(i).y) ? -1 : 1;
+        gcell.capacity = gcell.free_cells / this->tile_size;
+        if (gcell.capacity == 0 && gcell.free_cells > 0) {
+            gcell.capacity = 1;
+        }
+    }
+}
+
+/*
+
+    Counts the unblocked cells under every tile. A tile's capacity is the number of
+    free routing tracks it offers, i.e. its free cells divided by the tile size, so a
+    tile that is half covered by blockers can carry roughly half as many routes.
+
+*/
+void Utilities::GlobalRouter::build_gcells() {
+    GCell empty = { 0, 0, 0 };
+    this->gcells.assign(this->tiles_x * this->tiles_y, empty);
+    int max_height = this->map->get_height(), max_width = this->map->get_width();
+    for (int y = 0; y < max_height; y++) {
+        for (int x = 0; x < max_width; x++) {
+            if (!this->map->is_blocked(x, y)) {
+                this->gcells.at(this->tile_index(x, y)).free_cells++;
+            }
+        }
+    }
+    for (unsigned i = 0; i < this->gcells.size(); i++) {
+        GCell& gcell = this->gcells.at(i);
+        gcell.capacity = gcell.free_cells / this->tile_size;
+        if (gcell.capacity == 0 && gcell.free_cells > 0) {
+            gcell.capacity = 1;
+        }
+    }
+}
+
+int Utilities::GlobalRouter::tile_index(int x, int y) {
+    return (y / this->tile_size) * this->tiles_x + (x / this->tile_size);
+}
+
+// Only valid for cells whose tile is part of the current corridor
+int Utilities::GlobalRouter::cell_index(int x, int y) {
+    int slot = this->corridor_slot.at(this->tile_index(x, y));
+    return (slot * this->tile_size + (y % this->tile_size)) * this->tile_size + (x % this->tile_size);
+}
+
+/*
+
+    Parameter tile (int): The tile the global route wants to enter
+
+    Return int: The cost of entering the tile, or -1 if it has no free cells. Crossing a
+    tile costs its width in cells, plus a share for the cells blockers take away, plus
+    a congestion term that grows with usage and jumps once the tile is over capacity.
+
+*/
+int Utilities::GlobalRouter::entry_cost(int tile) {
+    GCell& gcell = this->gcells.at(tile);
+    if (gcell.free_cells == 0) {
+        return -1;
+    }
+    int area = this->tile_size * this->tile_size;
+    int cost = this->tile_size;
+    cost += (this->tile_size * (area - gcell.free_cells)) / area;
+    cost += (this->tile_size * gcell.usage) / gcell.capacity;
+    if (gcell.usage >= gcell.capacity) {
+        cost += 4 * this->tile_size;
+    }
+    return cost;
+}
+
+/*
+
+    Parameter source/sink (Point): The end points of the connection
+
+    Return vector<int>: The tiles from the source's tile to the sink's tile picked by a
+    Dijkstra search over the global grid, or an empty vector if the tiles are disconnected.
+
+*/
+vector<int> Utilities::GlobalRouter::global_route(Point source, Point sink) {
+    int num_tiles = this->tiles_x * this->tiles_y;
+    int start = this->tile_index(source.x, source.y);
+    int goal = this->tile_index(sink.x, sink.y);
+    vector<int> distance(num_tiles, -1);
+    vector<int> previous(num_tiles, -1);
+    priority_queue<pair<int, int>, vector<pair<int, int> >, greater<pair<int, int> > > open;
+
+    distance.at(start) = 0;
+    open.push(pair<int, int>(0, start));
+    while (!open.empty()) {
+        pair<int, int> current = open.top();
+        open.pop();
+        int tile = current.second;
+        if (current.first > distance.at(tile)) { continue; }    // stale queue entry
+        if (tile == goal) { break; }
+        int tile_x = tile % this->tiles_x, tile_y = tile / this->tiles_x;
+        for (int d = 0; d < 4; d++) {
+            int next_x = tile_x + kDx[d], next_y = tile_y + kDy[d];
+            if (next_x < 0 || next_x >= this->tiles_x || next_y < 0 || next_y >= this->tiles_y) { continue; }
+            int next = next_y * this->tiles_x + next_x;
+            int cost = this->entry_cost(next);
+            if (cost < 0) { continue; }
+            int next_distance = current.first + cost;
+            if (distance.at(next) == -1 || next_distance < distance.at(next)) {
+                distance.at(next) = next_distance;
+                previous.at(next) = tile;
+                open.push(pair<int, int>(next_distance, next));
+            }
+        }
+    }
+
+    vector<int> tile_path;
+    if (distance.at(goal) == -1) {
+        return tile_path;
+    }
+    for (int tile = goal; tile != -1; tile = previous.at(tile)) {
+        tile_path.push_back(tile);
+    }
+    std::reverse(tile_path.begin(), tile_path.end());
+    return tile_path;
+}
+
+/*
+
+    Parameter tile_path (vector<int>): The tiles picked by global_route
+              halo (int): How many tiles to widen the corridor by on every side
+
+    Return vector<int>: Every tile within halo tiles of the tile path
+
+*/
+vector<int> Utilities::GlobalRouter::corridor(const vector<int>& tile_path, int halo) {
+    vector<int> tiles;
+    for (unsigned i = 0; i < tile_path.size(); i++) {
+        int tile_x = tile_path.at(i) % this->tiles_x, tile_y = tile_path.at(i) / this->tiles_x;
+        for (int y = std::max(0, tile_y - halo); y <= std::min(this->tiles_y - 1, tile_y + halo); y++) {
+            for (int x = std::max(0, tile_x - halo); x <= std::min(this->tiles_x - 1, tile_x + halo); x++) {
+                int tile = y * this->tiles_x + x;
+                if (this->corridor_slot.at(tile) == -1) {
+                    this->corridor_slot.at(tile) = tiles.size();
+                    tiles.push_back(tile);
+                }
+            }
+        }
+    }
+    for (unsigned i = 0; i < tiles.size(); i++) {
+        this->corridor_slot.at(tiles.at(i)) = -1;
+    }
+    return tiles;
+}
+
+/*
+
+    Parameter source/sink (Point): The end points of the connection
+              corridor (vector<int>): The tiles the search may expand into
+              path (Path*): Filled in with the shortest path from source to sink that
+                            stays inside the corridor
+              stats (RouteStats*): Optional, the cells expanded and the backtrace time are
+                                   added to it and its queue high-water mark raised
+
+    Return bool: Whether the corridor connects source and sink. Lee's wave expansion,
+    but with its bookkeeping kept per corridor cell instead of per Map node.
+
+*/
+bool Utilities::GlobalRouter::detailed_route(Point source, Point sink, const vector<int>& corridor, Path* path,
+                                             RouteStats* stats) {
+    typedef std::chrono::steady_clock clock;
+    for (unsigned i = 0; i < corridor.size(); i++) {
+        this->corridor_slot.at(corridor.at(i)) = i;
+    }
+    this->came_from.assign(corridor.size() * this->tile_size * this->tile_size, -1);
+
+    int max_height = this->map->get_height(), max_width = this->map->get_width();
+    bool found_end = false;
+    std::queue<Point> wave_queue;
+    this->came_from.at(this->cell_index(source.x, source.y)) = 4;     // marks the source
+    wave_queue.push(source);
+    unsigned expanded = 0, queue_peak = 1;
+    while (!wave_queue.empty() && !found_end) {
+        queue_peak = std::max(queue_peak, (unsigned)wave_queue.size());
+        Point current = wave_queue.front();
+        wave_queue.pop();
+        expanded++;
+        for (int d = 0; d < 4; d++) {
+            int x = current.x + kDx[d], y = current.y + kDy[d];
+            if (x < 0 || x >= max_width || y < 0 || y >= max_height) { continue; }
+            if (this->corridor_slot.at(this->tile_index(x, y)) == -1) { continue; }    // outside the corridor
+            if (this->map->is_blocked(x, y)) { continue; }
+            int index = this->cell_index(x, y);
+            if (this->came_from.at(index) != -1) { continue; }
+            this->came_from.at(index) = d;
+            if (x == sink.x && y == sink.y) {
+                found_end = true;
+                break;
+            }
+            wave_queue.push(Point(x, y));
+        }
+    }
+
+    clock::time_point start = clock::now();
+    if (found_end) {
+        // Walk back from the sink, then emit the unit segments from the source forward
+        vector<Point> cells;
+        Point current = sink;
+        cells.push_back(current);
+        while (!(current == source)) {
+            int d = this->came_from.at(this->cell_index(current.x, current.y));
+            current = Point(current.x - kDx[d], current.y - kDy[d]);
+            cells.push_back(current);
+        }
+        path->set_source(source);
+        path->set_sink(sink);
+        for (int i = cells.size() - 1; i > 0; i--) {
+            path->add_segment(cells.at(i), cells.at(i - 1));
+        }
+    }
+    if (stats != NULL) {
+        stats->expanded += expanded;
+        stats->queue_peak = std::max(stats->queue_peak, std::max(queue_peak, (unsigned)wave_queue.size()));
+        stats->backtrace_ms += std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+
+    for (unsigned i = 0; i < corridor.size(); i++) {
+        this->corridor_slot.at(corridor.at(i)) = -1;
+    }
+    return found_end;
+}
+
+/*
+
+    Parameter connection (const Connection&): The connection to route
+              path (Path*): Filled in with the routed path, left without segments if the
+                            connection cannot be routed
+
+    Return bool: False if the connection itself is invalid. The corridor starts one tile
+    wider than the global route and is widened to the whole Map before the connection is
+    given up on. The Map's RouteReport, if it has one, gets the connection's statistics,
+    with the global route counted as part of the expansion.
+
+*/
+bool Utilities::GlobalRouter::route(const Connection& connection, Path* path) {
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start = clock::now();
+    RouteReport* report = this->map->get_report();
+    RouteStats stats;
+    stats.name = connection.name;
+
+    int max_height = this->map->get_height(), max_width = this->map->get_width();
+    Point source = connection.source, sink = connection.sink;
+    if (source.x < 0 || source.y < 0 || source.x >= max_width || source.y >= max_height ||
+            sink.x < 0 || sink.y < 0 || sink.x >= max_width || sink.y >= max_height) {
+        if (this->reporting) { claim("Connection " + connection.name + ": source or sink is out of bounds", kWarning); }
+        if (report != NULL) { report->add(stats); }
+        return false;
+    }
+    if (source == sink) {
+        if (this->reporting) { claim("Connection " + connection.name + ": source and sink are the same", kWarning); }
+        if (report != NULL) { report->add(stats); }
+        return false;
+    }
+    if (this->map->is_blocked(source.x, source.y) || this->map->is_blocked(sink.x, sink.y)) {
+        if (this->reporting) { claim("Connection " + connection.name + ": source or sink is part of a blocker", kWarning); }
+        if (report != NULL) {
+            stats.outcome = kRouteBlocked;
+            report->add(stats);
+        }
+        return false;
+    }
+
+    vector<int> tile_path = this->global_route(source, sink);
+    bool routed = false;
+    if (!tile_path.empty()) {
+        int whole_map = std::max(this->tiles_x, this->tiles_y);
+        for (int halo = 1; !routed; halo = (halo * 2 < whole_map) ? halo * 2 : whole_map) {
+            vector<int> tiles = this->corridor(tile_path, halo);
+            if (this->reporting) {
+                stringstream message;
+                message << "Connection " << connection.name << ": corridor of " << tiles.size() << " tiles ("
+                        << tiles.size() * this->tile_size * this->tile_size << " cells) of "
+                        << max_width * max_height << " Map cells";
+                claim(&message, kDebug);
+            }
+            routed = this->detailed_route(source, sink, tiles, path, report != NULL ? &stats : NULL);
+            if (halo == whole_map || tiles.size() == this->gcells.size()) { break; }
+        }
+    }
+    if (report != NULL) {
+        stats.outcome = routed ? kRouted : kRouteUnreachable;
+        stats.expansion_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count() - stats.backtrace_ms;
+        stats.length = path->get_length();
+        stats.bends = RouteReport::count_bends(*path);
+        report->add(stats);
+    }
+    if (!routed) {
+        if (this->reporting) { claim("Connection " + connection.name + ": no route exists between source and sink", kWarning); }
+        path->set_name(connection.name);
+        path->set_source(source);
+        path->set_sink(sink);
+        return true;
+    }
+    path->set_name(connection.name);
+
+    // Charge the route to every tile it actually crosses
+    this->charge(*path);
+    return true;
+}
+
+vector<Path> Utilities::GlobalRouter::route(const vector<Connection>& connections) {
+    PathCollector collector;
+    this->route(connections, &collector);
+    return collector.release();
+}
+
+/* Hands every path to sink as soon as it is routed, connections that are invalid are skipped */
+void Utilities::GlobalRouter::route(const vector<Connection>& connections, PathSink* sink) {
+    for (unsigned i = 0; i < connections.size(); i++) {
+        Path path;
+        if (this->route(connections.at(i), &path)) {
+            sink->path_ready(path);
+        }
+    }
+}
@@ -1,15 +1,87 @@
 
 #include "../Headers/map.h"
 #include "../Headers/problem_object.h"
+#include "../Headers/solution.h"
+#include "../Headers/eco.h"
+#include "../Headers/router_daemon.h"
+#include "../Headers/pipeline.h"
+#include "../Headers/overlap_checker.h"
+#include "../Headers/claim.h"
 #include <time.h>
 #include <cstdlib>
 #include <iostream>
+#include <utility>
 
 using std::cerr;
 using std::cout;
 using std::endl;
 
+//Hands paths that were routed all at once to the sink, the streaming modes hand them over as they are routed
+static void finish_paths(vector<Path>& paths, Utilities::PathSink* sink) {
+	for(unsigned i = 0; i < paths.size(); i++) {
+		sink->path_ready(paths.at(i));
+	}
+	paths.clear();
+}
+
+//Reports which paths short or run over blockers, the first few pairs by name
+static void report_overlaps(Utilities::OverlapChecker* checker, const vector<Blocker>& blockers) {
+	checker->add_blockers(blockers);
+	vector<Utilities::Overlap> overlaps = checker->check();
+	unsigned shorts = 0, blocked = 0;
+	//Overlaps come sorted by kind and pair, so each pair is one run of them
+	for(unsigned i = 0, end = 0; i < overlaps.size(); i = end) {
+		const Utilities::Overlap& overlap = overlaps.at(i);
+		for(end = i + 1; end < overlaps.size() && overlaps.at(end).kind == overlap.kind &&
+		        overlaps.at(end).first == overlap.first && overlaps.at(end).second == overlap.second; end++) { }
+		unsigned pairs = (overlap.kind == Utilities::kShort) ? shorts++ : blocked++;
+		if(pairs >= 10) { continue; }
+		stringstream message;
+		message << "Path " << checker->get_path_name(overlap.first) << " overlaps "
+		        << (overlap.kind == Utilities::kShort ? "path " + checker->get_path_name(overlap.second)
+		                                              : "blocker " + blockers.at(overlap.second).name)
+		        << " at (" << overlap.from.x << "," << overlap.from.y << ")";
+		if(end - i > 1) { message << " and " << end - i - 1 << " more places"; }
+		Utilities::claim(&message, Utilities::kWarning);
+	}
+	stringstream summary;
+	summary << "Checked " << checker->get_num_paths() << " paths (" << checker->get_num_segments()
+	        << " segments): " << shorts << " pairs of paths short, " << blocked << " paths run over blockers";
+	Utilities::claim(&summary, Utilities::kNote);
+}
+
 int main(int argc,char* argv[]) {
+	std::string solution_file, binary_file, report_file;
+	bool check = false;
+	for(int i = 2; i < argc; i++) {
+		if(std::string(argv[i]) == "--check") { check = true; }
+		if(i + 1 == argc) { continue; }
+		if(std::string(argv[i]) == "--solution") { solution_file = argv[i + 1]; }
+		if(std::string(argv[i]) == "--binary-solution") { binary_file = argv[i + 1]; }
+		if(std::string(argv[i]) == "--report") { report_file = argv[i + 1]; }
+	}
+	//With --check every routed path also goes to the overlap checker, which keeps only its segments
+	Utilities::OverlapChecker checker;
+	//With --report the search statistics of every connection are written out, as CSV for a .csv file
+	Utilities::RouteReport report;
+
+	//The pipelined mode loads the problem itself, routing while the file is still being parsed
+	if(argc > 2 && std::string(argv[2]) == "--pipeline") {
+		Utilities::PipelinedRouter pipeline((std::string(argv[1])));
+		//Each path is printed and written as soon as it is routed
+		Utilities::SolutionStream stream(solution_file, binary_file);
+		Utilities::PathTee tee(&checker, &stream);
+		if(!report_file.empty()) { pipeline.set_report(&report); }
+		pipeline.route(check ? (Utilities::PathSink*)&tee : &stream);
+		stream.finish();
+		if(check) { report_overlaps(&checker, pipeline.get_blockers()); }
+		if(!report_file.empty()) { report.write(report_file); }
+		stringstream timing;
+		timing << "Pipelined run: first route after " << pipeline.get_first_route_ms() << " ms, parsed after "
+		       << pipeline.get_parsed_ms() << " ms, all routed after " << pipeline.get_total_ms() << " ms";
+		Utilities::claim(&timing, Utilities::kNote);
+		return 0;
+	}
 
 	// DO NOT CHANGE THIS SECTION OF CODE
 	if(argc < 2) { 
@@ -19,8 +91,18 @@ int main(int argc,char* argv[]) {
 	Utilities::ProblemObject* first_problem = new Utilities::ProblemObject(std::string(argv[1]));
 	// EDIT FROM HERE DOWN
 
+	//Compile the problem to a binary image next to it, later runs load that instead of parsing
+	if(argc > 2 && std::string(argv[2]) == "--compile") {
+		std::string image = Utilities::ProblemObject::image_filename(std::string(argv[1]));
+		if(!first_problem->write_image(image)) { return 1; }
+		Utilities::claim("Wrote the problem image " + image, Utilities::kNote);
+		delete first_problem;
+		return 0;
+	}
+
 	//Create your problem map object (in our example, we use a simple Map, you should create your own)
-	Utilities::Map g(first_problem);
+	//The map takes over the connections of the problem object rather than copying them
+	Utilities::Map g(std::move(*first_problem));
 
 	/*
 	Note: we do not take into account the connections or blockers that exist in the Project Object
@@ -36,19 +118,48 @@ int main(int argc,char* argv[]) {
 	Path: a series of straight line segments, with a single source and a single sink
 	Netlist: a series of stright line segments, with a single source and more than one sink
 	*/
-	vector<Path*> paths = g.lee();
-
-	//Print the paths/netlists that you return from your algorithm
-	for(unsigned i = 0; i < paths.size(); i++) {
-		cout << "Path " << i << ": ";
-		paths.at(i)->print();
-        printf("Path length: %d (sanity check)", paths.at(i)->size());
-		Path* temp = paths.at(i);
-		delete temp;
-        printf("\n\n");
+	vector<Path> paths;
+	Utilities::SolutionStream stream(solution_file, binary_file);
+	Utilities::PathTee tee(&checker, &stream);
+	Utilities::PathSink* sink = check ? (Utilities::PathSink*)&tee : &stream;
+	if(!report_file.empty()) { g.set_report(&report); }
+	std::string mode = (argc > 2) ? std::string(argv[2]) : "";
+	if(mode == "--soukup") {
+		g.soukup(sink);
+	} else if(mode == "--dstar") {
+		//Optionally drop the blockers of a second problem file onto the routed map and replan
+		Utilities::ProblemObject* changes = NULL;
+		if(argc > 3 && argv[3][0] != '-') { changes = new Utilities::ProblemObject(std::string(argv[3])); }
+		paths = g.dstar(changes);
+		delete changes;
+	} else if(mode == "--eco") {
+		//Apply a delta to a previous solution of this problem, rerouting only what it touches
+		if(argc < 5) {
+			Utilities::claim("Usage: ./grid_router <test_file> --eco <previous_solution> <delta>", Utilities::kError);
+		}
+		Utilities::EcoDelta delta((std::string(argv[4])));
+		Utilities::EcoDiff diff;
+		Utilities::EcoRouter eco(&g);
+		paths = eco.apply(Utilities::read_solution(std::string(argv[3])), &delta, &diff);
+		Utilities::write_eco_diff("-", diff);
+	} else if(mode == "--daemon") {
+		//Keep the map warm and answer requests from a Unix socket, or stdin if none is given
+		Utilities::RouterDaemon daemon(&g);
+		if(argc > 3) {
+			daemon.serve_socket(std::string(argv[3]));
+		} else {
+			daemon.serve(std::cin, cout);
+		}
+		cerr << "Note: request latency p50 " << daemon.percentile(0.50) << " us, p99 "
+		     << daemon.percentile(0.99) << " us" << endl;
+	} else {
+		g.lee(sink);
 	}
 
-	paths.clear();
+	finish_paths(paths, sink);
+	stream.finish();
+	if(check) { report_overlaps(&checker, g.get_blockers()); }
+	if(!report_file.empty()) { report.write(report_file); }
 
 	delete first_problem;
 
@@ -3,14 +3,43 @@
 #include "../Headers/node.h"
 #include "../Headers/map.h"
 #include "../Headers/problem_object.h"
+#include "../Headers/global_router.h"
+#include "../Headers/dstar_lite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
 
 //Takes an x and y coordinate as input and creates a Map of that size filled with default nodes
 Utilities::Map::Map(ProblemObject* problem_object) {
     this->connections = problem_object->get_connections();
-    this->num_connections = problem_object->get_connections().size();
-    int height = problem_object->get_height();
-    int width = problem_object->get_width();
+    this->num_connections = this->connections.size();
+    this->found_end = false;
+    this->report = NULL;
+    this->build_nodes(problem_object->get_width(), problem_object->get_height());
+    this->set_blockers(problem_object->get_blockers());          // Sets the map block.
+}
+
+//Same as above, but the connections are moved out of the problem object instead of copied, leaving it without them
+Utilities::Map::Map(ProblemObject&& problem_object) {
+    this->connections = problem_object.release_connections();
+    this->num_connections = this->connections.size();
+    this->found_end = false;
+    this->report = NULL;
+    this->build_nodes(problem_object.get_width(), problem_object.get_height());
+    this->set_blockers(problem_object.get_blockers());          // Sets the map block.
+}
+
+//Creates a Map without connections straight from its size and blockers, for callers that do not parse a problem file
+Utilities::Map::Map(int width, int height, const vector<Blocker>& blockers) {
+    this->num_connections = 0;
     this->found_end = false;
+    this->report = NULL;
+    this->build_nodes(width, height);
+    this->set_blockers(blockers);
+}
+
+void Utilities::Map::build_nodes(int width, int height) {
     for (int y = 0; y < height; y++) {
         vector<Node*> temp_row;
         for (int x = 0; x < width; x++) {
@@ -27,7 +56,6 @@ Utilities::Map::Map(ProblemObject* problem_object) {
         }
         this->map.push_back(temp_row);
     }
-    this->set_blockers(problem_object->get_blockers());          // Sets the map block.
 }
 
 //Destructs the Map by deleting each node individually, the node destructors will delete their own set of edges
@@ -35,7 +63,7 @@ Utilities::Map::~Map() {
     int width = this->get_width();
     int height = this->get_height();
     for (int x = 0; x < width; x++) {
-        for (int y = 0; y < width; y++) {
+        for (int y = 0; y < height; y++) {
             delete map.at(y).at(x);
         }
     }
@@ -55,6 +83,24 @@ int Utilities::Map::get_num_connections() {
     return this->num_connections;
 }
 
+const vector<Connection>& Utilities::Map::get_connections() {
+    return this->connections;
+}
+
+// Only the blockers that passed validate_blockers, with any added or removed since
+const vector<Blocker>& Utilities::Map::get_blockers() {
+    return this->blockers;
+}
+
+// Blockers are stored as nodes with a cost of -1, see set_blockers
+bool Utilities::Map::is_blocked(int x, int y) {
+    return this->map.at(y).at(x)->get_cost() == -1;
+}
+
+Utilities::RouteReport* Utilities::Map::get_report() {
+    return this->report;
+}
+
 Node* Utilities::Map::get_node(int x, int y) {
     if (y >= this->map.size()) {
         claim("Attemping to access a node outside of the Map's range (y-value out of range)", kError);
@@ -71,11 +117,11 @@ Node* Utilities::Map::get_node(Point coord) {
     return this->get_node(coord.x, coord.y);
 }
 
-vector<Path*> Utilities::Map::get_paths() {
+const vector<Path>& Utilities::Map::get_paths() {
     return this->paths;
 }
 
-Path* Utilities::Map::get_path(int i) {
+Path& Utilities::Map::get_path(int i) {
     if (i >= paths.size()) {
         claim("Attempting to access a path outside of the path list's range", kError);
     }
@@ -91,26 +137,31 @@ void Utilities::Map::replace_node(Node* replacement_node) {
     this->map.at(replacement_node->get_y()).at(replacement_node->get_x()) = replacement_node;
 }
 
-void Utilities::Map::set_paths(vector<Path*> paths) {
-    this->paths = paths;
+/* Pass NULL to stop collecting, the report is not owned by the map */
+void Utilities::Map::set_report(RouteReport* report) {
+    this->report = report;
+}
+
+void Utilities::Map::set_paths(vector<Path> paths) {
+    this->paths = std::move(paths);
 }
 
-void Utilities::Map::add_path(Path* path) {
-    this->paths.push_back(path);
+void Utilities::Map::add_path(Path path) {
+    this->paths.push_back(std::move(path));
 }
 
-void Utilities::Map::replace_path(int i, Path* path) {
+void Utilities::Map::replace_path(int i, Path path) {
     if (i >= this->paths.size()) {
         claim("Attemping to replace path outside of the path list's range", kError);
     }
-    paths.at(i) = path;
+    paths.at(i) = std::move(path);
 }
 
 void Utilities::Map::remove_path(int i) {
     if (i >= paths.size()) {
         claim("Attempting to remove a path outside of the path list's range", kError);
     }
-    vector<Path*>::iterator it = this->paths.begin();
+    vector<Path>::iterator it = this->paths.begin();
     it += i;
     paths.erase(it);
 }
@@ -128,10 +179,10 @@ void Utilities::Map::print_map()
         printf("%4d", i);
     }
     printf("\n\n");
-    for (unsigned int x = 0; x < max_width; x++)
+    for (unsigned int x = 0; x < max_height; x++)
     {
         printf("%4d", x );
-        for (unsigned int y = 0; y < max_height; y++)
+        for (unsigned int y = 0; y < max_width; y++)
         {            
             printf("%4d", this->map.at(x).at(y)->get_cost());
         }
@@ -144,12 +195,12 @@ void Utilities::Map::print_map()
 
 /*
 
-    Parameter blockers (vector<Blocker>): Used to set blocker nodes within the map
+    Parameter blockers (const vector<Blocker>&): Used to set blocker nodes within the map
 
     Return void: "removes" blocker nodes from map within function.
 
 */
-void Utilities::Map::set_blockers(vector<Blocker> blockers) {
+void Utilities::Map::set_blockers(const vector<Blocker>& blockers) {
 
     int x = 0, y = 0;
     int max_height = this->get_height(), max_width = this->get_width();    // Used for blocker bounds checking
@@ -163,6 +214,7 @@ void Utilities::Map::set_blockers(vector<Blocker> blockers) {
             goto block_loop;    // moves on to the next loop if a bad block is found
         }
 
+        this->blockers.push_back(blockers.at(i));
         x = blockers.at(i).location.x;
         y = blockers.at(i).location.y;
         
@@ -179,13 +231,77 @@ void Utilities::Map::set_blockers(vector<Blocker> blockers) {
 
 /*
 
-    Parameter block (Blocker): The current block to validate
+    Parameter blocker (Blocker): A blocker to add to an already built (and possibly routed) map
+
+    Return vector<Point>: The cells that flipped from free to blocked, so incremental
+    routers can repair only the affected part of their search.
+
+*/
+vector<Point> Utilities::Map::add_blocker(Blocker blocker) {
+    vector<Point> changed;
+    if (!this->validate_blockers(blocker, this->get_width(), this->get_height())) {
+        return changed;
+    }
+    this->blockers.push_back(blocker);
+    for (unsigned int y = blocker.location.y; y < blocker.location.y + blocker.height; y++) {
+        for (unsigned int x = blocker.location.x; x < blocker.location.x + blocker.width; x++) {
+            if (map.at(y).at(x)->get_cost() != -1) {
+                map.at(y).at(x)->set_cost(-1);
+                changed.push_back(Point(x, y));
+            }
+        }
+    }
+    return changed;
+}
+
+/*
+
+    Parameter blocker (Blocker): A blocker previously applied to the map, matched by its
+                                 location and size
+
+    Return vector<Point>: The cells that flipped from blocked to free. Cells that are also
+    covered by another remaining blocker stay blocked and are not reported.
+
+*/
+vector<Point> Utilities::Map::remove_blocker(Blocker blocker) {
+    vector<Point> changed;
+    vector<Blocker>::iterator it = this->blockers.begin();
+    for (; it != this->blockers.end(); it++) {
+        if (it->location == blocker.location && it->width == blocker.width && it->height == blocker.height) {
+            break;
+        }
+    }
+    if (it == this->blockers.end()) {
+        claim("Blocker " + blocker.name + " is not on the map, nothing to remove", kWarning);
+        return changed;
+    }
+    this->blockers.erase(it);
+    for (unsigned int y = blocker.location.y; y < blocker.location.y + blocker.height; y++) {
+        for (unsigned int x = blocker.location.x; x < blocker.location.x + blocker.width; x++) {
+            bool still_covered = false;
+            for (unsigned i = 0; i < this->blockers.size() && !still_covered; i++) {
+                Blocker& other = this->blockers.at(i);
+                still_covered = x >= other.location.x && x < other.location.x + other.width &&
+                                y >= other.location.y && y < other.location.y + other.height;
+            }
+            if (!still_covered) {
+                map.at(y).at(x)->set_cost(0);
+                changed.push_back(Point(x, y));
+            }
+        }
+    }
+    return changed;
+}
+
+/*
+
+    Parameter block (const Blocker&): The current block to validate
        max_width/height (int): passed in so that they wouldn't have to be continuously calculated
 
     Return bool: Whether the current block is viable within out given map.
 
 */
-bool Utilities::Map::validate_blockers(Blocker block, int max_width, int max_height) {
+bool Utilities::Map::validate_blockers(const Blocker& block, int max_width, int max_height) {
 
     int x = block.location.x;
     int y = block.location.y;
@@ -225,12 +341,12 @@ bool Utilities::Map::validate_blockers(Blocker block, int max_width, int max_hei
 }
 
 //Note, we create random paths just as an example of how to create paths, netlists are created similarly
-vector<Path*> Utilities::Map::test_algorithm() {
-    vector<Path*> paths;
+vector<Path> Utilities::Map::test_algorithm() {
+    vector<Path> paths;
     srand(time(NULL));
     int number_paths = this->get_num_connections();
     for (int i = 0; i < number_paths; i++) {
-        Path* new_path = new Path();
+        Path new_path;
         int x = rand() % this->get_width();
         int y = rand() % this->get_height();
         int path_length = 1 + rand() % 10;
@@ -239,10 +355,9 @@ vector<Path*> Utilities::Map::test_algorithm() {
             Point head(x, y);
             direction ? x += 1 : y += 1;
             Point tail(x, y);
-            PathSegment* new_segment = new PathSegment(head, tail);
-            new_path->add_segment(new_segment);
+            new_path.add_segment(head, tail);
         }
-        paths.push_back(new_path);
+        paths.push_back(std::move(new_path));
     }
     return paths;
 }
@@ -251,58 +366,199 @@ vector<Path*> Utilities::Map::test_algorithm() {
  
     Parameter none: Implements the base lee's algorithm
 
-    Return vector<Path*>: Returns a vector of shortest paths from
+    Return vector<Path>: Returns a vector of shortest paths from
     their respective connections.
     
 */
-vector<Path*> Utilities::Map::lee() {
+vector<Path> Utilities::Map::lee() {
+    PathCollector collector;
+    this->lee(&collector);
+    return collector.release();
+}
 
-    int max_connections = this->get_num_connections();
-    
+/*
+
+    Parameter sink (PathSink*): Gets each shortest path as soon as it is found
+
+    Routes the connections in order exactly as lee() does, but keeps none of the paths.
+
+*/
+void Utilities::Map::lee(PathSink* sink) {
+    for (int i = 0; i < this->get_num_connections(); i++) {
+        Path new_path;
+        if (this->lee_route(this->connections.at(i), i, &new_path)) {
+            sink->path_ready(new_path);
+        }
+    }
+}
+
+/*
+
+    Parameter connection (const Connection&): The connection to route
+              index (int): Its position in the problem, used in messages
+              path (Path*): Filled in with the shortest path for the connection, found
+                            with the same wave expansion and backtrace lee() uses
+
+    Return bool: Whether the connection was routed, false if it is invalid or trivial.
+    The map itself keeps no record of the path, the report set with set_report gets its
+    search statistics.
+
+*/
+bool Utilities::Map::lee_route(const Connection& connection, int index, Path* path) {
+    typedef std::chrono::steady_clock clock;
     int max_height = this->get_height(), max_width = this->get_width();
-    unsigned int i = 0;
-    
-    connection_loop:
-    for (; i < max_connections; i++)
-    {       
-        if (!(this->validate_connections(connections.at(i), i))) { // checks if source/sink are valid
-            ++i;
-            goto connection_loop;
+    RouteStats stats;
+    stats.name = connection.name;
+
+    if (!(this->validate_connections(connection, index))) { // checks if source/sink are valid
+        if (this->report != NULL) {
+            this->report->add(stats);
         }
+        return false;
+    }
 
-        // Reset map costs after each iteration
+    // Reset map costs before each connection, timed on its own as it is O(width * height) whatever the route
+    clock::time_point start = clock::now();
+    for (unsigned int y = 0; y < max_height; y++)
+    {
         for (unsigned int x = 0; x < max_width; x++)
         {
-            for (unsigned int y = 0; y < max_height; y++)
-            {
-                if (this->map.at(x).at(y)->get_cost() != -1) {
-                    this->map.at(x).at(y)->set_cost(0);
-                    this->map.at(x).at(y)->set_queue_status(false);
-                }
+            if (this->map.at(y).at(x)->get_cost() != -1) {
+                this->map.at(y).at(x)->set_cost(0);
+                this->map.at(y).at(x)->set_queue_status(false);
             }
         }
-        std::stack<Node*> x;
-        
-        Node* source = this->map.at(this->connections.at(i).source.y).at(this->connections.at(i).source.x);
-        Node* sink = this->map.at(this->connections.at(i).sink.y).at(this->connections.at(i).sink.x);
-        if (simple_path(source, sink, i)) { // no need to waste computation time
-            ++i;
-            goto connection_loop;
+    }
+
+    stats.reset_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    Node* source = this->map.at(connection.source.y).at(connection.source.x);
+    Node* sink = this->map.at(connection.sink.y).at(connection.sink.x);
+    if (simple_path(source, sink, index)) { // no need to waste computation time
+        if (this->report != NULL) {
+            stats.outcome = (source == sink) ? kRouteInvalid : kRouteBlocked;
+            this->report->add(stats);
         }
-        source->set_cost(-2);
-        sink->set_cost(-3);
-        
-        printf("\n\nSource x: %d, y: %d\n", source->get_x(), source->get_y());
-        printf("Sink x: %d, y: %d", sink->get_x(), source->get_y());
+        return false;
+    }
+    source->set_cost(-2);
+    sink->set_cost(-3);
+
+    start = clock::now();
+    this->wave_expansion(source, &stats);    // Fills out map with all relevant node costs
+    bool reached = found_end;
+    found_end = false;
+    stats.expansion_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    printf("\n\nSource x: %d, y: %d\n", source->get_x(), source->get_y());
+    printf("Sink x: %d, y: %d", sink->get_x(), sink->get_y());
+    this->print_map();
+    stats.print_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    path->set_name(connection.name);
+    path->set_sink(sink->get_coord());
+    this->backtrace(sink, path);    // Determines the lowest cost path
+    if (this->report != NULL) {
+        stats.backtrace_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        stats.outcome = reached ? kRouted : kRouteUnreachable;
+        stats.length = path->get_length();
+        stats.bends = RouteReport::count_bends(*path);
+        this->report->add(stats);
+    }
+    return true;
+}
 
-        this->wave_expansion(source);    // Fills out map with all relevant node costs
-        found_end = false;
-        this->print_map();
-        
-        Path* new_path = new Path();
-        paths.push_back(this->backtrace(sink, new_path));    // Determines the lowest cost path and pushes it onto paths
+/*
+
+    Parameter tile_size (int): Width and height, in cells, of one global routing tile
+
+    Return vector<Path>: Routes every connection by first picking a corridor of tiles
+    on the coarse global grid and then running the maze search inside that corridor only.
+
+*/
+vector<Path> Utilities::Map::soukup(int tile_size) {
+    GlobalRouter router(this, tile_size);
+    return router.route(this->connections);
+}
+
+/* As above, with every path handed to sink as soon as it is routed */
+void Utilities::Map::soukup(PathSink* sink, int tile_size) {
+    GlobalRouter router(this, tile_size);
+    router.route(this->connections, sink);
+}
+
+/*
+
+    Parameter changes (ProblemObject*): Optional problem whose blockerList is dropped onto
+                                        the map after the first routing pass
+
+    Return vector<Path>: Routes every connection with an incremental D* Lite search. When
+    changes are given, every search is repaired in place and the repair time is reported
+    next to the time a from-scratch reroute of the same connection takes.
+
+*/
+vector<Path> Utilities::Map::dstar(ProblemObject* changes) {
+    typedef std::chrono::steady_clock clock;
+    vector<DStarLite*> planners;
+    vector<string> names;
+    for (unsigned int i = 0; i < this->connections.size(); i++) {
+        if (!(this->validate_connections(connections.at(i), i))) {
+            continue;
+        }
+        Node* source = this->get_node(connections.at(i).source);
+        Node* sink = this->get_node(connections.at(i).sink);
+        if (simple_path(source, sink, i)) {
+            continue;
+        }
+        DStarLite* planner = new DStarLite(this, source->get_coord(), sink->get_coord());
+        planner->compute_shortest_path();
+        planners.push_back(planner);
+        names.push_back(connections.at(i).name);
     }
-    return paths;
+
+    if (changes != NULL) {
+        vector<Point> changed;
+        const vector<Blocker>& new_blockers = changes->get_blockers();
+        for (unsigned i = 0; i < new_blockers.size(); i++) {
+            vector<Point> flipped = this->add_blocker(new_blockers.at(i));
+            changed.insert(changed.end(), flipped.begin(), flipped.end());
+        }
+        stringstream applied;
+        applied << "Applied " << new_blockers.size() << " new blockers, " << changed.size() << " cells changed";
+        claim(&applied, kNote);
+
+        for (unsigned i = 0; i < planners.size(); i++) {
+            clock::time_point start = clock::now();
+            planners.at(i)->update_cells(changed);
+            planners.at(i)->compute_shortest_path();
+            double repair_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+            int repair_expansions = planners.at(i)->get_expansions();
+
+            start = clock::now();
+            DStarLite scratch(this, planners.at(i)->get_source(), planners.at(i)->get_sink());
+            scratch.compute_shortest_path();
+            double scratch_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+            stringstream report;
+            report << "Replan " << i << ": repaired in " << repair_ms << " ms (" << repair_expansions
+                   << " expansions), from scratch " << scratch_ms << " ms (" << scratch.get_expansions()
+                   << " expansions)";
+            claim(&report, kNote);
+            if (planners.at(i)->get_distance() != scratch.get_distance()) {
+                claim("Repaired D* Lite search disagrees with the from-scratch search", kWarning);
+            }
+        }
+    }
+
+    vector<Path> routed;
+    for (unsigned i = 0; i < planners.size(); i++) {
+        routed.push_back(planners.at(i)->get_path());
+        routed.back().set_name(names.at(i));
+        delete planners.at(i);
+    }
+    return routed;
 }
 
 /*
@@ -327,12 +583,12 @@ bool Utilities::Map::simple_path(Node* source, Node* sink, int path)
 
 /*
 
-Parameter connections (Connection): The current source and sink
+Parameter connections (const Connection&): The current source and sink
                         path (int): The current working path
 Return Bool: Whether or not the source and sink are within bounds
 
 */
-bool Utilities::Map::validate_connections(Connection connections, int path) {
+bool Utilities::Map::validate_connections(const Connection& connections, int path) {
 
     if (connections.source.x < 0 || connections.source.y < 0) {
         //claim("The connections source is invalid (negative) !!", kError);
@@ -344,12 +600,12 @@ bool Utilities::Map::validate_connections(Connection connections, int path) {
         printf("\nError: Connection %d: sink is invalid (negative) !!\n\n", path);
         return false;
     }
-    else if (connections.source.x >= this->get_height() || connections.source.y >= this->get_width()) {
+    else if (connections.source.x >= this->get_width() || connections.source.y >= this->get_height()) {
         //claim("The connections source is invalid (out of bounds) !!", kError);
         printf("\nError: Connection %d: source is invalid (out of bounds) !!\n\n", path);
         return false;
     }
-    else if (connections.sink.x >= this->get_height() || connections.sink.y >= this->get_width()) {
+    else if (connections.sink.x >= this->get_width() || connections.sink.y >= this->get_height()) {
         //claim("The connections sink is invalid (out of bounds) !!", kError);
         printf("\nError: Connection %d: sink is invalid (out of bounds) !!\n\n", path);
         return false;
@@ -362,21 +618,27 @@ bool Utilities::Map::validate_connections(Connection connections, int path) {
 Parameter cur_node (Node*): The current map position.
 Used to update all valid positions within the map by using a queue to
 keep track of node positions. (Previously...recursive ;_;)
+Parameter stats (RouteStats*): Optional, gets the nodes expanded and the queue high-water mark
 Return nothing.
 
 */
-void Utilities::Map::wave_expansion(Node* source){
+void Utilities::Map::wave_expansion(Node* source, RouteStats* stats){
    
     std::queue<Node*> wave_queue;
     wave_queue.push(source);
     int max_height = this->get_height(), max_width = this->get_width();
+    unsigned expanded = 0, queue_peak = 1;
     
     while (!wave_queue.empty() && !found_end) {
+        if (wave_queue.size() > queue_peak) {
+            queue_peak = wave_queue.size();
+        }
         Node* cur_node = wave_queue.front();
         wave_queue.pop();
+        expanded++;
         
         // Right
-        if (cur_node->get_y() + 1 < get_width()) {
+        if (cur_node->get_y() + 1 < max_height) {
             Node* right = this->get_node(cur_node->get_x(), cur_node->get_y() + 1);
             if (right->get_cost() == -1 || right->get_cost() == -2) { /* do nothing, at wall */ }
             else if (right->queue_status()) { /* do nothing, already in queue */ }
@@ -422,7 +684,7 @@ void Utilities::Map::wave_expansion(Node* source){
             }
         }
         // Up
-        if (cur_node->get_x() + 1 < get_height()) {
+        if (cur_node->get_x() + 1 < max_width) {
             Node* up = this->get_node(cur_node->get_x() + 1, cur_node->get_y());
             if (up->get_cost() == -1 || up->get_cost() == -2) { /* do nothing, at wall */ }
             else if (up->queue_status()) { /* do nothing, already in queue */ }
@@ -468,6 +730,10 @@ void Utilities::Map::wave_expansion(Node* source){
             }
         }
     }
+    if (stats != NULL) {
+        stats->expanded += expanded;
+        stats->queue_peak = std::max(stats->queue_peak, std::max(queue_peak, (unsigned)wave_queue.size()));
+    }
     
     // Up
     /*if (cur_node->get_y() + 1 < this->get_height()) { // Check bounds
@@ -599,8 +865,7 @@ Path* Utilities::Map::backtrace(Node* sink, Path* path) {
             {                
                 y++;
                 //printf("Right: %d, %d\n", y, x);
-                PathSegment* new_segment = new PathSegment(map.at(x).at(y - 1)->get_coord(), map.at(x).at(y)->get_coord());
-                path->add_segment(new_segment);
+                path->add_segment(map.at(x).at(y - 1)->get_coord(), map.at(x).at(y)->get_coord());
                 
                 if (map.at(x).at(y)->get_cost() == -2) {
                     path->set_source(map.at(x).at(y)->get_coord());
@@ -616,8 +881,7 @@ Path* Utilities::Map::backtrace(Node* sink, Path* path) {
             {                
                 y--;
                 //printf("Left: %d, %d\n", y, x);
-                PathSegment* new_segment = new PathSegment(map.at(x).at(y + 1)->get_coord(), map.at(x).at(y)->get_coord());
-                path->add_segment(new_segment);
+                path->add_segment(map.at(x).at(y + 1)->get_coord(), map.at(x).at(y)->get_coord());
                 
                 if (map.at(x).at(y)->get_cost() == -2) {
                     path->set_source(map.at(x).at(y)->get_coord());
@@ -633,8 +897,7 @@ Path* Utilities::Map::backtrace(Node* sink, Path* path) {
             {                
                 x++;
                 //printf("Up: %d, %d\n", y, x);
-                PathSegment* new_segment = new PathSegment(map.at(x - 1).at(y)->get_coord(), map.at(x).at(y)->get_coord());
-                path->add_segment(new_segment);
+                path->add_segment(map.at(x - 1).at(y)->get_coord(), map.at(x).at(y)->get_coord());
                 
                 if (map.at(x).at(y)->get_cost() == -2) {
                     path->set_source(map.at(x).at(y)->get_coord());
@@ -650,8 +913,7 @@ Path* Utilities::Map::backtrace(Node* sink, Path* path) {
             {                
                 x--;
                 //printf("Down: %d, %d\n", y, x);
-                PathSegment* new_segment = new PathSegment(map.at(x + 1).at(y)->get_coord(), map.at(x).at(y)->get_coord());
-                path->add_segment(new_segment);
+                path->add_segment(map.at(x + 1).at(y)->get_coord(), map.at(x).at(y)->get_coord());
                 
                 if (map.at(x).at(y)->get_cost() == -2) {
                     path->set_source(map.at(x).at(y)->get_coord());
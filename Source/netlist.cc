@@ -8,11 +8,11 @@ Utilities::Netlist::~Netlist() {
     /* Emptry Destructor */
 }
 
-Point Utilities::Netlist::get_source() {
+Point Utilities::Netlist::get_source() const {
     return this->source;
 }
 
-vector<Point> Utilities::Netlist::get_sinks() {
+const vector<Point>& Utilities::Netlist::get_sinks() const {
     return this->sinks;
 }
 
@@ -15,13 +15,14 @@ Utilities::Node::Node(Point coord, int cost):coord(coord.x,coord.y){
 }
 
 Utilities::Node::~Node() {
-      for(int i=0; i < connections.size(); i++) {
-            Edge* edge_to_remove = this->connections.at(i);
-            //Remove the edge from the node at the other end of the edge's connection list
+      //Pop from the back, removing while indexing forward skipped every other edge and left dangling ones behind
+      while(!this->connections.empty()) {
+            Edge* edge_to_remove = this->connections.back();
+            //Remove the edge from the current object's connection list
+            this->connections.pop_back();
 			if (edge_to_remove) { 
+				//Remove the edge from the node at the other end of the edge's connection list
 				edge_to_remove->get_end(this)->remove_connection(edge_to_remove);
-				//Remove the edge from the current object's connection list
-				this->remove_connection(edge_to_remove);
 				//Delete edge
 				delete edge_to_remove;
 			}
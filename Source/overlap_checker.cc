@@ -0,0 +1,239 @@
+#include "../Headers/overlap_checker.h"
+#include "../Headers/claim.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+using std::min;
+using std::max;
+
+/* Packs a coordinate above a box index, so sorting the keys sorts the boxes by that coordinate */
+static inline uint64_t sort_key(int coordinate, unsigned box) {
+    return ((uint64_t)((uint32_t)coordinate ^ 0x80000000u) << 32) | box;
+}
+
+/* The box indices in order of coordinate, read through key_of */
+template <typename KeyOf>
+static vector<unsigned> sorted_boxes(unsigned count, KeyOf key_of) {
+    vector<uint64_t> keys(count);
+    for (unsigned i = 0; i < count; i++) {
+        keys[i] = sort_key(key_of(i), i);
+    }
+    std::sort(keys.begin(), keys.end());
+    vector<unsigned> order(count);
+    for (unsigned i = 0; i < count; i++) {
+        order[i] = (unsigned)keys[i];
+    }
+    return order;
+}
+
+Utilities::OverlapChecker::OverlapChecker() {
+    this->num_paths = 0;
+    this->num_blockers = 0;
+    this->leaves = 0;
+}
+
+Utilities::OverlapChecker::~OverlapChecker() {
+    /* Empty Destructor */
+}
+
+unsigned Utilities::OverlapChecker::get_num_paths() const {
+    return this->num_paths;
+}
+
+unsigned Utilities::OverlapChecker::get_num_segments() const {
+    unsigned segments = 0;
+    for (unsigned i = 0; i < this->boxes.size(); i++) {
+        if (this->boxes[i].owner >= 0) {
+            segments++;
+        }
+    }
+    return segments;
+}
+
+string Utilities::OverlapChecker::get_path_name(unsigned index) const {
+    return this->path_names.at(index);
+}
+
+/*
+
+    Parameter path (const Path&): A routed path, its segments must be straight. It is
+    numbered by the order paths are added in, which is the order Overlap reports them by.
+
+*/
+void Utilities::OverlapChecker::add_path(const Path& path) {
+    int owner = this->num_paths++;
+    this->path_names.push_back(path.get_name());
+    for (unsigned i = 0; i < path.size(); i++) {
+        Point source = path.at(i).get_source(), sink = path.at(i).get_sink();
+        if (source.x != sink.x && source.y != sink.y) {
+            claim("Path " + path.get_name() + " has a segment that is not straight, it is not checked", kWarning);
+            continue;
+        }
+        Box box;
+        box.x1 = min(source.x, sink.x);
+        box.y1 = min(source.y, sink.y);
+        box.x2 = max(source.x, sink.x);
+        box.y2 = max(source.y, sink.y);
+        box.owner = owner;
+        this->boxes.push_back(box);
+    }
+}
+
+void Utilities::OverlapChecker::add_paths(const vector<Path>& paths) {
+    for (unsigned i = 0; i < paths.size(); i++) {
+        this->add_path(paths.at(i));
+    }
+}
+
+/* Blockers cover location.x to location.x + width - 1, the same cells Map::set_blockers blocks */
+void Utilities::OverlapChecker::add_blockers(const vector<Blocker>& blockers) {
+    for (unsigned i = 0; i < blockers.size(); i++) {
+        int owner = -(int)(++this->num_blockers);
+        if (blockers.at(i).width == 0 || blockers.at(i).height == 0) {
+            continue;
+        }
+        Box box;
+        box.x1 = blockers.at(i).location.x;
+        box.y1 = blockers.at(i).location.y;
+        box.x2 = box.x1 + (int)blockers.at(i).width - 1;
+        box.y2 = box.y1 + (int)blockers.at(i).height - 1;
+        box.owner = owner;
+        this->boxes.push_back(box);
+    }
+}
+
+void Utilities::OverlapChecker::path_ready(Path& path) {
+    this->add_path(path);
+}
+
+/* Sorts the boxes by their low end and starts every tree node off empty */
+void Utilities::OverlapChecker::build_tree() {
+    const vector<Box>& boxes = this->boxes;
+    this->by_low = sorted_boxes(boxes.size(), [&](unsigned i) { return boxes[i].y1; });
+    this->lows.resize(boxes.size());
+    for (unsigned i = 0; i < boxes.size(); i++) {
+        this->lows[i] = boxes[this->by_low[i]].y1;
+    }
+    this->leaves = 1;
+    while (this->leaves < boxes.size()) {
+        this->leaves *= 2;
+    }
+    this->max_high.assign(2 * this->leaves, INT_MIN);
+}
+
+/*
+
+    Puts the box at position of by_low into the sweep with its y2 as high, or takes it out
+    with a high of INT_MIN, and fixes max_high above it. Going up stops at the first node
+    whose max_high does not change, usually a level or two up, rather than at the root.
+
+*/
+void Utilities::OverlapChecker::set_in_sweep(unsigned position, int high) {
+    unsigned node = this->leaves + position;
+    this->max_high[node] = high;
+    for (node /= 2; node > 0; node /= 2) {
+        int high = max(this->max_high[2 * node], this->max_high[2 * node + 1]);
+        if (this->max_high[node] == high) {
+            break;
+        }
+        this->max_high[node] = high;
+    }
+}
+
+/*
+
+    Parameter node (unsigned): Tree node covering positions lo to hi - 1 of by_low
+    Parameter box (unsigned): The box about to enter the sweep
+    Parameter found (vector<Overlap>*): Gets an Overlap for each box in the sweep it meets
+
+    A node is skipped when nothing in it reaches up to the box's y1, or when even its
+    lowest box starts above the box's y2. Every box still in the sweep already spans
+    the box's x1, so meeting in y is all that is left to check.
+
+*/
+void Utilities::OverlapChecker::find_overlaps(unsigned node, unsigned lo, unsigned hi, unsigned box,
+                                              vector<Overlap>* found) const {
+    const Box& entering = this->boxes[box];
+    if (lo >= this->lows.size() || this->lows[lo] > entering.y2 || this->max_high[node] < entering.y1) {
+        return;
+    }
+    if (hi - lo > 1) {
+        unsigned mid = (lo + hi) / 2;
+        this->find_overlaps(2 * node, lo, mid, box, found);
+        this->find_overlaps(2 * node + 1, mid, hi, box, found);
+        return;
+    }
+
+    const Box& other = this->boxes[this->by_low[lo]];
+    if (other.owner == entering.owner || (other.owner < 0 && entering.owner < 0)) {
+        return;
+    }
+    Overlap overlap;
+    if (other.owner >= 0 && entering.owner >= 0) {
+        overlap.kind = kShort;
+        overlap.first = min(other.owner, entering.owner);
+        overlap.second = max(other.owner, entering.owner);
+    } else {
+        overlap.kind = kBlocked;
+        overlap.first = max(other.owner, entering.owner);
+        overlap.second = -min(other.owner, entering.owner) - 1;
+    }
+    overlap.from = Point(max(other.x1, entering.x1), max(other.y1, entering.y1));
+    overlap.to = Point(min(other.x2, entering.x2), min(other.y2, entering.y2));
+    found->push_back(overlap);
+}
+
+/*
+
+    Return vector<Overlap>: Every short and every path over a blocker, sorted by kind and
+    then by the paths involved. Where two paths meet on a bend of one of them, the cell
+    is reported once, not once per segment of the bend.
+
+*/
+vector<Utilities::Overlap> Utilities::OverlapChecker::check() {
+    vector<Overlap> found;
+    const vector<Box>& boxes = this->boxes;
+    this->build_tree();
+
+    // Where each box sits in by_low, and the order boxes enter and leave the sweep
+    vector<unsigned> position(boxes.size());
+    for (unsigned i = 0; i < boxes.size(); i++) {
+        position[this->by_low[i]] = i;
+    }
+    vector<unsigned> entering = sorted_boxes(boxes.size(), [&](unsigned i) { return boxes[i].x1; });
+    vector<unsigned> leaving = sorted_boxes(boxes.size(), [&](unsigned i) { return boxes[i].x2; });
+
+    unsigned next_leaving = 0;
+    for (unsigned i = 0; i < entering.size(); i++) {
+        unsigned box = entering[i];
+        // Boxes that end on the column this one starts on still overlap it, so they leave after
+        while (next_leaving < leaving.size() && boxes[leaving[next_leaving]].x2 < boxes[box].x1) {
+            this->set_in_sweep(position[leaving[next_leaving]], INT_MIN);
+            next_leaving++;
+        }
+        this->find_overlaps(1, 0, this->leaves, box, &found);
+        this->set_in_sweep(position[box], boxes[box].y2);
+    }
+
+    std::sort(found.begin(), found.end(), [](const Overlap& a, const Overlap& b) {
+        if (a.kind != b.kind) { return a.kind < b.kind; }
+        if (a.first != b.first) { return a.first < b.first; }
+        if (a.second != b.second) { return a.second < b.second; }
+        if (a.from.x != b.from.x) { return a.from.x < b.from.x; }
+        if (a.from.y != b.from.y) { return a.from.y < b.from.y; }
+        if (a.to.x != b.to.x) { return a.to.x < b.to.x; }
+        return a.to.y < b.to.y;
+    });
+    found.erase(std::unique(found.begin(), found.end(), [](const Overlap& a, const Overlap& b) {
+        return a.kind == b.kind && a.first == b.first && a.second == b.second &&
+               a.from == b.from && a.to == b.to;
+    }), found.end());
+
+    // The tree is only needed during the sweep
+    vector<unsigned>().swap(this->by_low);
+    vector<int>().swap(this->lows);
+    vector<int>().swap(this->max_high);
+    return found;
+}
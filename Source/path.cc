@@ -9,14 +9,22 @@ Utilities::Path::~Path() {
     /* Emptry Destructor */
 }
 
-Point Utilities::Path::get_source() {
+string Utilities::Path::get_name() const {
+    return this->name;
+}
+
+Point Utilities::Path::get_source() const {
     return this->source;
 }
 
-Point Utilities::Path::get_sink() {
+Point Utilities::Path::get_sink() const {
     return this->sink;
 }
 
+void Utilities::Path::set_name(string name) {
+    this->name = name;
+}
+
 void Utilities::Path::set_source(Point source) {
     this->source = source;
 }
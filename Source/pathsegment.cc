@@ -44,41 +44,41 @@ Utilities::PathSegment::~PathSegment() {
     /* Empty Destructor */
 }
 
-bool Utilities::PathSegment::operator==(const PathSegment& rhs) {
+bool Utilities::PathSegment::operator==(const PathSegment& rhs) const {
     if(this->source == rhs.source && this->sink == rhs.sink) {
         return true;
     }
     return false;
 }
 
-Point Utilities::PathSegment::get_source() {
+Point Utilities::PathSegment::get_source() const {
     return this->source;
 }
 
-Point Utilities::PathSegment::get_sink() {
+Point Utilities::PathSegment::get_sink() const {
     return this->sink;
 }
 
-int Utilities::PathSegment::get_length() {
+int Utilities::PathSegment::get_length() const {
     return this->length;
 }
 
-bool Utilities::PathSegment::contains_points(Point source, Point sink) {
+bool Utilities::PathSegment::contains_points(Point source, Point sink) const {
     if(source == this->source && sink == this->sink) {
         return true;
     }
     return false;
 }
 
-void Utilities::PathSegment::print_source() {
+void Utilities::PathSegment::print_source() const {
     cout << "(" << this->source.x << "," << this->source.y << ")";
 }
 
-void Utilities::PathSegment::print_sink() {
+void Utilities::PathSegment::print_sink() const {
     cout << "(" << this->sink.x << "," << this->sink.y << ")";
 }
 
-void Utilities::PathSegment::print() {
+void Utilities::PathSegment::print() const {
     this->print_source();
     cout << " -> ";
     this->print_sink();
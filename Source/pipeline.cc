@@ -0,0 +1,152 @@
+#include "../Headers/pipeline.h"
+#include "../Headers/claim.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+typedef std::chrono::steady_clock pipeline_clock;
+
+static double elapsed_ms(pipeline_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(pipeline_clock::now() - start).count();
+}
+
+Utilities::PipelinedRouter::PipelinedRouter(string filename) {
+    this->filename = filename;
+    this->ready = false;
+    this->finished = false;
+    this->width = 0;
+    this->height = 0;
+    this->report = NULL;
+    this->first_route_ms = -1;
+    this->parsed_ms = 0;
+    this->total_ms = 0;
+}
+
+Utilities::PipelinedRouter::~PipelinedRouter() {
+    /* Empty Destructor */
+}
+
+double Utilities::PipelinedRouter::get_first_route_ms() {
+    return this->first_route_ms;
+}
+
+double Utilities::PipelinedRouter::get_parsed_ms() {
+    return this->parsed_ms;
+}
+
+double Utilities::PipelinedRouter::get_total_ms() {
+    return this->total_ms;
+}
+
+/* The blockers of the problem as parsed, once route() has returned */
+const vector<Blocker>& Utilities::PipelinedRouter::get_blockers() {
+    return this->blockers;
+}
+
+/* As Map::set_report, every connection route() routes is added to report */
+void Utilities::PipelinedRouter::set_report(RouteReport* report) {
+    this->report = report;
+}
+
+void Utilities::PipelinedRouter::problem_ready(unsigned int width, unsigned int height, const vector<Blocker>& blockers) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->width = width;
+    this->height = height;
+    this->blockers = blockers;
+    this->ready = true;
+    this->changed.notify_one();
+}
+
+void Utilities::PipelinedRouter::connection_ready(const Connection& connection) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->queue.push_back(connection);
+    if (this->queue.size() == 1) {
+        this->changed.notify_one();
+    }
+}
+
+/*
+
+    Return vector<Path>: The paths lee() would find for the problem file, routed while
+    the file is still being parsed. Connections that cannot be routed are left out, as
+    in lee().
+
+*/
+vector<Path> Utilities::PipelinedRouter::route() {
+    PathCollector collector;
+    this->route(&collector);
+    return collector.release();
+}
+
+/*
+
+    Parameter sink (PathSink*): Gets each path as soon as it is routed, which can be long
+    before the file has been parsed to the end
+
+*/
+void Utilities::PipelinedRouter::route(PathSink* sink) {
+    pipeline_clock::time_point start = pipeline_clock::now();
+    this->first_route_ms = -1;
+
+    if (ProblemObject::image_is_current(this->filename)) {
+        ProblemObject problem(this->filename);
+        Map map(std::move(problem));
+        map.set_report(this->report);
+        map.lee(sink);
+        this->parsed_ms = this->total_ms = elapsed_ms(start);
+        return;
+    }
+
+    ProblemBuilder builder;
+    builder.set_listener(this);
+    std::thread parser([&]() {
+        json_parse(this->filename, &builder);
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->parsed_ms = elapsed_ms(start);
+        this->finished = true;
+        this->changed.notify_one();
+    });
+
+    std::unique_lock<std::mutex> waiting(this->lock);
+    this->changed.wait(waiting, [this]() { return this->ready || this->finished; });
+    if (!this->ready) {
+        waiting.unlock();
+        parser.join();
+        claim("The JSON parser failed because the file input has no objects", kError);
+    }
+    waiting.unlock();
+
+    //Build the map here while the parser moves on through the routeList
+    Map map(this->width, this->height, this->blockers);
+    map.set_report(this->report);
+    int index = 0;
+    deque<Connection> batch;
+    while (true) {
+        waiting.lock();
+        this->changed.wait(waiting, [this]() { return !this->queue.empty() || this->finished; });
+        batch.swap(this->queue);
+        bool done = this->finished && batch.empty();
+        waiting.unlock();
+        if (done) { break; }
+
+        for (unsigned i = 0; i < batch.size(); i++, index++) {
+            Path path;
+            if (map.lee_route(batch.at(i), index, &path)) {
+                sink->path_ready(path);
+            }
+            if (this->first_route_ms < 0) {
+                this->first_route_ms = elapsed_ms(start);
+            }
+        }
+        batch.clear();
+    }
+    parser.join();
+
+    //Same checks and warnings as loading the problem up front
+    if (!builder.is_complete()) {
+        claim("The JSON parser failed because the file input has no objects", kError);
+    }
+    ProblemObject problem(&builder);
+    this->total_ms = elapsed_ms(start);
+}
@@ -0,0 +1,307 @@
+#include "../Headers/problem_builder.h"
+#include "../Utilities/JSON_parser/Headers/json_split.h"
+
+#include <thread>
+#include <iterator>
+
+// Below this many bytes of routeList per thread the file is parsed on one thread
+static const size_t kMinRunSize = 4 * 1024 * 1024;
+
+Utilities::ProblemBuilder::ProblemBuilder() {
+	this->width = 0;
+	this->height = 0;
+	this->complete = false;
+	this->blocker_list = false;
+	this->route_list = false;
+	this->blocker_list_size = 0;
+	this->route_list_size = 0;
+	this->unnamed_blockers = 0;
+	this->unnamed_connections = 0;
+	this->depth = 0;
+	this->top_level_values = 0;
+	this->in_problem = false;
+	this->list = kNoList;
+	this->in_entry = false;
+	this->field = kOther;
+	this->problem_seen = 0;
+	this->entry_seen = 0;
+	this->entry_named = false;
+	this->listener = NULL;
+	this->announced = false;
+	this->streamed = 0;
+}
+
+Utilities::ProblemBuilder::~ProblemBuilder() {
+	/* Empty Destructor */
+}
+
+void Utilities::ProblemBuilder::set_listener(ProblemListener* listener) {
+	this->listener = listener;
+}
+
+// Puts a builder inside the routeList of a problem, to read a run of its entries
+void Utilities::ProblemBuilder::start_route_run() {
+	this->in_problem = true;
+	this->depth = 2;
+	this->list = kRoutes;
+}
+
+// Adds the entries read by a run builder after the ones read so far, emptying the run
+void Utilities::ProblemBuilder::append_routes(ProblemBuilder* run) {
+	this->connections.insert(this->connections.end(),
+		std::make_move_iterator(run->connections.begin()),std::make_move_iterator(run->connections.end()));
+	run->connections.clear();
+	this->route_list_size += run->route_list_size;
+	this->unnamed_connections += run->unnamed_connections;
+}
+
+// Hands the size and blockers to the listener, along with any connections read before
+void Utilities::ProblemBuilder::announce() {
+	this->announced = true;
+	this->listener->problem_ready(this->width, this->height, this->blockers);
+	for(; this->streamed < this->connections.size(); this->streamed++) {
+		this->listener->connection_ready(this->connections.at(this->streamed));
+	}
+}
+
+/*
+
+	Parameter key (JsonString): A name as the scanner found it, already hashed
+
+	Return Field: Which field the name is, kOther if none. Names are told apart by their
+	hash, a name is only compared against the one field whose hash it matches.
+
+*/
+Utilities::ProblemBuilder::Field Utilities::ProblemBuilder::lookup(const JsonString& key) {
+	static const JSON::JsonKey names[kFieldCount] = {
+		JSON::JsonKey(""),JSON::JsonKey("name"),JSON::JsonKey("width"),JSON::JsonKey("height"),
+		JSON::JsonKey("blockerList"),JSON::JsonKey("routeList"),JSON::JsonKey("x"),JSON::JsonKey("y"),
+		JSON::JsonKey("source_x"),JSON::JsonKey("source_y"),JSON::JsonKey("sink_x"),JSON::JsonKey("sink_y")
+	};
+	unsigned hash = JSON::string_hash(key);
+	for(int field = kName; field < kFieldCount; field++) {
+		if(names[field].hash == hash) {
+			return JSON::string_matches(key,names[field]) ? (Field)field : kOther;
+		}
+	}
+	return kOther;
+}
+
+// Whether the value being parsed belongs directly to a field of the problem or a list entry
+bool Utilities::ProblemBuilder::at_field() {
+	return this->field != kOther &&
+		((this->in_problem && this->depth == 1) || (this->in_entry && this->depth == 3));
+}
+
+// Every value directly inside a list counts towards its size, objects or not
+void Utilities::ProblemBuilder::begin_value() {
+	if(this->list == kBlockers && this->depth == 2) {
+		this->blocker_list_size++;
+	} else if(this->list == kRoutes && this->depth == 2) {
+		this->route_list_size++;
+	}
+}
+
+void Utilities::ProblemBuilder::start_object() {
+	this->begin_value();
+	if(this->depth == 0 && this->top_level_values == 0 && !this->in_problem && !this->complete) {
+		this->in_problem = true;
+	} else if(this->list != kNoList && this->depth == 2) {
+		this->in_entry = true;
+		this->entry_seen = 0;
+		this->entry_named = false;
+		this->blocker = Blocker();
+		this->blocker.width = 0;
+		this->blocker.height = 0;
+		this->connection = Connection();
+	}
+	this->depth++;
+}
+
+void Utilities::ProblemBuilder::end_object() {
+	this->depth--;
+	if(this->in_entry && this->depth == 2) {
+		this->in_entry = false;
+		if(this->list == kBlockers) {
+			this->blockers.push_back(this->blocker);
+			if(!this->entry_named) { this->unnamed_blockers++; }
+		} else {
+			this->connections.push_back(this->connection);
+			if(!this->entry_named) { this->unnamed_connections++; }
+			if(this->announced) {
+				this->listener->connection_ready(this->connection);
+				this->streamed++;
+			}
+		}
+	} else if(this->in_problem && this->depth == 0) {
+		this->in_problem = false;
+		this->complete = true;
+		if(this->listener && !this->announced) { this->announce(); }
+	}
+}
+
+void Utilities::ProblemBuilder::start_array() {
+	this->begin_value();
+	if(this->at_field() && this->depth == 1) {
+		if(this->field == kBlockerList) {
+			this->list = kBlockers;
+			this->blocker_list = true;
+		} else if(this->field == kRouteList) {
+			this->list = kRoutes;
+			this->route_list = true;
+			unsigned header = (1u << kWidth) | (1u << kHeight) | (1u << kBlockerList);
+			if(this->listener && !this->announced && (this->problem_seen & header) == header) {
+				this->announce();
+			}
+		}
+	}
+	this->depth++;
+}
+
+void Utilities::ProblemBuilder::end_array() {
+	this->depth--;
+	if(this->list != kNoList && this->depth == 1) {
+		this->list = kNoList;
+	}
+}
+
+/*
+
+	Parameter name (JsonString): The name of the name-value being opened
+
+	Picks out the fields the problem and its list entries care about. Anything else,
+	including the second occurrence of a field, is parsed past without being read.
+
+*/
+void Utilities::ProblemBuilder::start_name_value(const JsonString& name) {
+	this->field = kOther;
+	if(this->depth == 0) {
+		this->top_level_values++;
+		return;
+	}
+	unsigned* seen;
+	Field found;
+	if(this->in_problem && this->depth == 1) {
+		found = this->lookup(name);
+		if(found > kRouteList) { return; }
+		seen = &this->problem_seen;
+	} else if(this->in_entry && this->depth == 3) {
+		found = this->lookup(name);
+		bool blocker_field = (found == kWidth || found == kHeight || found == kX || found == kY);
+		bool route_field = (found >= kSourceX && found <= kSinkY);
+		if(found != kName && !(this->list == kBlockers ? blocker_field : route_field)) { return; }
+		seen = &this->entry_seen;
+	} else {
+		return;
+	}
+	if(found == kOther || (*seen & (1u << found))) { return; }
+	*seen |= (1u << found);
+	this->field = found;
+}
+
+void Utilities::ProblemBuilder::end_name_value() {
+	if(this->depth == 0) { this->top_level_values--; }
+	this->field = kOther;
+}
+
+void Utilities::ProblemBuilder::string_value(const JsonString& value) {
+	this->begin_value();
+	if(!this->at_field() || this->field != kName) { return; }
+	if(this->in_entry) {
+		string entry_name = JSON::decode_string(value);
+		if(this->list == kBlockers) {
+			this->blocker.name = entry_name;
+		} else {
+			this->connection.name = entry_name;
+		}
+		this->entry_named = true;
+	} else {
+		this->name = JSON::decode_string(value);
+	}
+}
+
+void Utilities::ProblemBuilder::int_value(int value) {
+	this->begin_value();
+	if(!this->at_field()) { return; }
+	if(!this->in_entry) {
+		if(this->field == kWidth) { this->width = value; }
+		else if(this->field == kHeight) { this->height = value; }
+		return;
+	}
+	switch(this->field) {
+		case kWidth: this->blocker.width = value; break;
+		case kHeight: this->blocker.height = value; break;
+		case kX: this->blocker.location.x = value; break;
+		case kY: this->blocker.location.y = value; break;
+		case kSourceX: this->connection.source.x = value; break;
+		case kSourceY: this->connection.source.y = value; break;
+		case kSinkX: this->connection.sink.x = value; break;
+		case kSinkY: this->connection.sink.y = value; break;
+		default: break;
+	}
+}
+
+/* Other values only take up a field (which then reads as 0 or unnamed) or a list slot */
+void Utilities::ProblemBuilder::float_value(float value) {
+	this->begin_value();
+}
+
+void Utilities::ProblemBuilder::bool_value(bool value) {
+	this->begin_value();
+}
+
+void Utilities::ProblemBuilder::null_value() {
+	this->begin_value();
+}
+
+/*
+
+	Parameter filename (string): The problem file to read
+
+	Parameter builder (ProblemBuilder*): An empty builder, filled in with the problem
+
+	Return type: bool, whether the file was read and parsed. A routeList large enough
+	to be worth it is split into runs by a pre-scan and the runs are parsed on their
+	own threads while this one parses the rest of the file. If the pre-scan or any
+	part fails, the file is parsed again on one thread, so the problem, the warnings
+	and any syntax error are the same as json_parse() would give.
+
+*/
+bool Utilities::parse_problem(string filename, ProblemBuilder* builder) {
+	unsigned threads = std::thread::hardware_concurrency();
+	JSON::JsonInput input;
+	vector<const char*> bounds;
+	if(threads > 1 && input.load(filename) && input.size() >= 2 * kMinRunSize) {
+		unsigned parts = std::min<size_t>(threads,input.size() / kMinRunSize);
+		if(JSON::split_member_array(input.begin(),input.end(),"routeList",parts,&bounds) && bounds.size() > 2) {
+			unsigned runs = bounds.size() - 1;
+			vector<ProblemBuilder> run_builders(runs);
+			vector<char> parsed(runs,false);
+			vector<std::thread> workers;
+			for(unsigned i = 1; i < runs; i++) {
+				workers.push_back(std::thread([&,i]() {
+					run_builders.at(i).start_route_run();
+					parsed.at(i) = json_parse_values(filename,&run_builders.at(i),bounds.at(i) + 1,bounds.at(i + 1));
+				}));
+			}
+			bool ok = json_parse_skipping(filename,builder,&input,bounds.front(),bounds.back());
+			run_builders.at(0).start_route_run();
+			parsed.at(0) = json_parse_values(filename,&run_builders.at(0),bounds.at(0),bounds.at(1));
+			for(unsigned i = 0; i < workers.size(); i++) {
+				workers.at(i).join();
+			}
+			for(unsigned i = 0; i < runs; i++) {
+				ok = ok && parsed.at(i);
+			}
+			if(ok) {
+				for(unsigned i = 0; i < runs; i++) {
+					builder->append_routes(&run_builders.at(i));
+				}
+				return true;
+			}
+			*builder = ProblemBuilder();
+		}
+	}
+	input.release();
+	return json_parse(filename,builder);
+}
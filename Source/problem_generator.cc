@@ -0,0 +1,242 @@
+#include "../Headers/problem_generator.h"
+#include "../Headers/claim.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+
+using std::ofstream;
+using std::min;
+using std::max;
+
+static const int kMaxSide = 10000;
+static const int kMaxIdle = 1000;      // blockers in a row that cover nothing new before giving up on the density
+
+Utilities::GeneratorOptions::GeneratorOptions() {
+    this->width = 1000;
+    this->height = 1000;
+    this->seed = 1;
+    this->density = 0.1;
+    this->min_blocker = 1;
+    this->max_blocker = 20;
+    this->sizes = kUniformSizes;
+    this->clusters = 0;
+    this->routes = 100;
+    this->min_length = 10;
+    this->max_length = 500;
+}
+
+Utilities::ProblemGenerator::ProblemGenerator(const GeneratorOptions& options) {
+    this->options = options;
+}
+
+Utilities::ProblemGenerator::~ProblemGenerator() {
+    /* Empty Destructor */
+}
+
+const vector<Blocker>& Utilities::ProblemGenerator::get_blockers() const {
+    return this->blockers;
+}
+
+const vector<Connection>& Utilities::ProblemGenerator::get_connections() const {
+    return this->connections;
+}
+
+/* Uniform from lo to hi inclusive. The modulo bias is far below anything a benchmark notices */
+int Utilities::ProblemGenerator::draw(int lo, int hi) {
+    return lo + (int)(this->random() % (uint32_t)(hi - lo + 1));
+}
+
+/* Uniform in [0, 1) */
+double Utilities::ProblemGenerator::unit() {
+    return this->random() / 4294967296.0;
+}
+
+int Utilities::ProblemGenerator::blocker_side() {
+    int lo = this->options.min_blocker, hi = this->options.max_blocker;
+    if (this->options.sizes == kSmallSizes) {
+        double u = this->unit();
+        return min(hi, lo + (int)((hi - lo + 1) * u * u * u));
+    }
+    return this->draw(lo, hi);
+}
+
+/* Where a width x height blocker goes, evenly over the grid or close to one of the centres */
+Point Utilities::ProblemGenerator::blocker_corner(int width, int height, const vector<Point>& centres) {
+    int max_x = this->options.width - width, max_y = this->options.height - height;
+    if (centres.empty()) {
+        return Point(this->draw(0, max_x), this->draw(0, max_y));
+    }
+    const Point& centre = centres.at(this->draw(0, centres.size() - 1));
+    int spread = max(1, min(this->options.width, this->options.height) / 8);
+    int x = centre.x - width / 2 + this->draw(-spread, spread) + this->draw(-spread, spread);
+    int y = centre.y - height / 2 + this->draw(-spread, spread) + this->draw(-spread, spread);
+    return Point(min(max(x, 0), max_x), min(max(y, 0), max_y));
+}
+
+bool Utilities::ProblemGenerator::is_free(int x, int y) {
+    if (x < 0 || y < 0 || x >= this->options.width || y >= this->options.height) {
+        return false;
+    }
+    return !this->blocked[(size_t)y * this->options.width + x];
+}
+
+/* Adds blockers until density of the cells is covered, overlaps only count once */
+void Utilities::ProblemGenerator::add_blockers() {
+    int width = this->options.width, height = this->options.height;
+    long long target = (long long)(this->options.density * width * height);
+    long long covered = 0;
+    vector<Point> centres;
+    for (int i = 0; i < this->options.clusters; i++) {
+        centres.push_back(Point(this->draw(0, width - 1), this->draw(0, height - 1)));
+    }
+
+    int idle = 0;
+    while (covered < target && idle < kMaxIdle) {
+        int blocker_width, blocker_height;
+        if (this->options.sizes == kWallSizes) {
+            int length = this->blocker_side(), thickness = this->draw(1, 2);
+            bool across = this->draw(0, 1);
+            blocker_width = across ? length : thickness;
+            blocker_height = across ? thickness : length;
+        } else {
+            blocker_width = this->blocker_side();
+            blocker_height = this->blocker_side();
+        }
+        blocker_width = min(blocker_width, width);
+        blocker_height = min(blocker_height, height);
+        Point corner = this->blocker_corner(blocker_width, blocker_height, centres);
+
+        long long added = 0;
+        for (int y = corner.y; y < corner.y + blocker_height; y++) {
+            for (int x = corner.x; x < corner.x + blocker_width; x++) {
+                size_t cell = (size_t)y * width + x;
+                if (!this->blocked[cell]) {
+                    this->blocked[cell] = true;
+                    added++;
+                }
+            }
+        }
+        if (added == 0) {
+            idle++;
+            continue;
+        }
+        idle = 0;
+        covered += added;
+
+        Blocker blocker;
+        stringstream name;
+        name << "blocker" << this->blockers.size();
+        blocker.name = name.str();
+        blocker.location = corner;
+        blocker.width = blocker_width;
+        blocker.height = blocker_height;
+        this->blockers.push_back(blocker);
+    }
+    if (covered < target) {
+        stringstream message;
+        message << "Blockers only cover " << covered << " of the " << target << " cells asked for";
+        claim(&message, kWarning);
+    }
+}
+
+/* Routes between free cells, a source with no free cell at the drawn length is given up for another */
+void Utilities::ProblemGenerator::add_routes() {
+    long long attempts = 0, limit = 100LL * this->options.routes + kMaxIdle;
+    while ((int)this->connections.size() < this->options.routes && attempts++ < limit) {
+        Point source(this->draw(0, this->options.width - 1), this->draw(0, this->options.height - 1));
+        if (!this->is_free(source.x, source.y)) {
+            continue;
+        }
+        int length = this->draw(this->options.min_length, this->options.max_length);
+        int dx = this->draw(-length, length);
+        int dy = (length - abs(dx)) * (this->draw(0, 1) ? 1 : -1);
+        Point sink(source.x + dx, source.y + dy);
+        if (!this->is_free(sink.x, sink.y)) {
+            continue;
+        }
+
+        Connection connection;
+        stringstream name;
+        name << "route" << this->connections.size();
+        connection.name = name.str();
+        connection.source = source;
+        connection.sink = sink;
+        this->connections.push_back(connection);
+    }
+    if ((int)this->connections.size() < this->options.routes) {
+        stringstream message;
+        message << "Only " << this->connections.size() << " of " << this->options.routes
+                << " routes fit, the grid is too small or too blocked for their length";
+        claim(&message, kWarning);
+    }
+}
+
+/* Checks the options and draws the blockers and routes, starting over from the seed */
+void Utilities::ProblemGenerator::generate() {
+    const GeneratorOptions& options = this->options;
+    if (options.width < 1 || options.height < 1 || options.width > kMaxSide || options.height > kMaxSide) {
+        claim("Generated problems must be between 1x1 and 10000x10000 cells", kError);
+    }
+    if (options.density < 0.0 || options.density > 0.9) {
+        claim("Blocker density must be between 0 and 0.9", kError);
+    }
+    if (options.min_blocker < 1 || options.max_blocker < options.min_blocker) {
+        claim("Blocker sizes must be at least one cell, smallest first", kError);
+    }
+    if (options.min_length < 1 || options.max_length < options.min_length) {
+        claim("Route lengths must be at least one cell, shortest first", kError);
+    }
+    if (options.routes < 0 || options.clusters < 0) {
+        claim("The number of routes and of clusters cannot be negative", kError);
+    }
+
+    this->random.seed(options.seed);
+    this->blocked.assign((size_t)options.width * options.height, false);
+    this->blockers.clear();
+    this->connections.clear();
+    this->add_blockers();
+    this->add_routes();
+}
+
+/* Writes the problem in the layout of Tests/test_sample.json, named after the file */
+void Utilities::ProblemGenerator::write(string filename) const {
+    ofstream out(filename.c_str());
+    if (!out.is_open()) {
+        claim("Unable to open problem file " + filename + " for writing", kError);
+    }
+    string name = filename.substr(filename.find_last_of('/') + 1);
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+        name.erase(name.size() - 5);
+    }
+
+    out << "{\n\t\"file_name\": " << quote_string(name) << ",\n\n";
+    out << "\t\"height\": " << this->options.height << ",\n\t\"width\": " << this->options.width << ",\n\n";
+    out << "\t\"blockerList\": [";
+    for (unsigned i = 0; i < this->blockers.size(); i++) {
+        const Blocker& blocker = this->blockers.at(i);
+        out << (i ? ",\n" : "\n") << "\t{\"name\": \"" << blocker.name << "\", \"width\": " << blocker.width
+            << ", \"height\": " << blocker.height << ", \"x\": " << blocker.location.x
+            << ", \"y\": " << blocker.location.y << "}";
+    }
+    out << "\n\t],\n\n\t\"routeList\": [";
+    for (unsigned i = 0; i < this->connections.size(); i++) {
+        const Connection& connection = this->connections.at(i);
+        out << (i ? ",\n" : "\n") << "\t{\"name\": \"" << connection.name << "\", \"source_x\": " << connection.source.x
+            << ", \"source_y\": " << connection.source.y << ", \"sink_x\": " << connection.sink.x
+            << ", \"sink_y\": " << connection.sink.y << "}";
+    }
+    out << "\n\t]\n}\n";
+    if (!out.good()) {
+        claim("Unable to write problem file " + filename, kError);
+    }
+}
+
+/* The names benchmark --blocker-sizes takes */
+Utilities::BlockerSizes Utilities::ProblemGenerator::parse_sizes(string name) {
+    if (name == "uniform") { return kUniformSizes; }
+    if (name == "small") { return kSmallSizes; }
+    if (name == "walls") { return kWallSizes; }
+    claim("Unknown blocker sizes " + name + ", expected uniform, small or walls", kError);
+    return kUniformSizes;
+}
@@ -1,119 +1,393 @@
 #include "../Headers/problem_object.h"
+#include "../Headers/problem_builder.h"
+#include "../Headers/problem_image.h"
 #include "../Headers/claim.h"
 
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 Utilities::ProblemObject::ProblemObject() {
 	this->name = "";
 	this->width = 0;
 	this->height = 0;
+	this->empty_blocker_list = false;
+	this->empty_route_list = false;
+	this->unnamed_blockers = 0;
+	this->unnamed_connections = 0;
+	memset(&this->source,0,sizeof(this->source));
 }
 
 Utilities::ProblemObject::ProblemObject(string filename) {
-	//Create a new JSON file object and parse the file given
-	JSON::JsonFile* json_file = new JSON::JsonFile();
-	json_parse(filename,json_file);
+	this->width = 0;
+	this->height = 0;
+	this->empty_blocker_list = false;
+	this->empty_route_list = false;
+	this->unnamed_blockers = 0;
+	this->unnamed_connections = 0;
+
+	//Taken before reading, so a change made while the file is read leaves any image stale
+	read_source_stamp(filename,&this->source);
+	//A compiled image of the file as it is now holds the same problem and skips the parser
+	if(!image_is_current(filename) || !load_image(image_filename(filename))) {
+		load_json(filename);
+	}
+	report_load_warnings();
+	//And now were done with a fully formed problem
+}
+
+//Takes over a problem that was streamed through builder, which is left empty
+Utilities::ProblemObject::ProblemObject(ProblemBuilder* builder) {
+	memset(&this->source,0,sizeof(this->source));
+	this->take(builder);
+	report_load_warnings();
+}
 
-	//Check that there is at least one object, otherwise there is nothing to do (malformed JSON)
-	if(json_file->objects_size() < 1) {
+void Utilities::ProblemObject::load_json(string filename) {
+	/*
+	Stream the file through a ProblemBuilder, which fills in the blockers and connections as
+	the parser reaches them instead of building the whole JSON tree first. A large routeList
+	is parsed on several threads
+	*/
+	ProblemBuilder builder;
+	parse_problem(filename,&builder);
+
+	//Check that the problem object was read in full, otherwise there is nothing to do (malformed JSON)
+	if(!builder.is_complete()) {
 		claim("The JSON parser failed because the file input has no objects",kError);
 	}
 
-	//We expect there to be one object, so we want to get that object
-	JSON::JsonObject* file_object = json_file->objects_at(0);
+	this->take(&builder);
+}
 
-	//First we extract the name, which requires looking for the name tag
-	JsonValue* problem_name = file_object->find("name");
-	//First we check that we got a return from teh call to find("name")
-	if(problem_name) {
-		//If we did get a return, then we want to check that what we got was a string
-		if(problem_name->is_string()) {
-			//If it is a string, then we want to extract the value as a string and assign it
-			this->name = problem_name->get_string();
-		}
-	} else {
-		//Otherwise, we just assign an empty string
-		this->name = "";
+void Utilities::ProblemObject::take(ProblemBuilder* builder) {
+	this->name = builder->get_name();
+	this->height = builder->get_height();
+	this->width = builder->get_width();
+	this->blockers.swap(builder->get_blockers());
+	this->connections.swap(builder->get_connections());
+
+	//Keep what the lists would have warned about when read one entry at a time
+	this->empty_blocker_list = builder->has_blocker_list() && builder->get_blocker_list_size() <= 0;
+	this->empty_route_list = builder->has_route_list() && builder->get_route_list_size() <= 0;
+	this->unnamed_blockers = builder->get_unnamed_blockers();
+	this->unnamed_connections = builder->get_unnamed_connections();
+}
+
+void Utilities::ProblemObject::report_load_warnings() {
+	if(this->empty_blocker_list) {
+		claim("There are no blockers in this system, this is possible but unusual",kWarning);
+	}
+	for(unsigned i = 0; i < this->unnamed_blockers; i++) {
+		claim("Blocker does not have a name, likely malformed JSON file",kWarning);
+	}
+	if(this->empty_route_list) {
+		claim("There are no routes in this system, this is possible but unusual",kWarning);
 	}
+	for(unsigned i = 0; i < this->unnamed_connections; i++) {
+		claim("Connection does not have a name, likely malformed JSON file",kWarning);
+	}
+}
 
-	//Extract the width and the height of the problem as integers
-	this->height = extract_int(file_object->find("height"));
-	this->width = extract_int(file_object->find("width"));
+Utilities::ProblemObject::~ProblemObject() {
+	/* Empty Destructor */
+}
 
-	/*
-	Now we want to get the list of blockers (squares in the Map that are invalid for routing), however since
-	there are many of these in one problem, we represent them in the JSON object as an array
-	*/
-	JsonValue* list = file_object->find("blockerList");
-	//We have to make sure that this list is an array, otherwise we have a malformed JSON object
-	if(list && list->is_array()) {
-		JsonArray* array = list->get_array();
-		if(array->size() <= 0) {
-			claim("There are no blockers in this system, this is possible but unusual",kWarning);
-		} else {
-			/*
-			We now know this is a JSON array, so we need to iterate through it, check that each part is an
-			object (if not, its some bit of malformed JSON object), and then add the blocker
-			*/
-			for(unsigned i = 0; i < array->size(); i++) {
-				JsonValue* current_value = array->at(i);
-				if(current_value->is_object()) {
-					add_blocker(current_value->get_object());
-				}
-			}
-		}
+vector<Connection> Utilities::ProblemObject::release_connections() {
+	vector<Connection> released;
+	released.swap(this->connections);
+	return released;
+}
+
+vector<Blocker> Utilities::ProblemObject::release_blockers() {
+	vector<Blocker> released;
+	released.swap(this->blockers);
+	return released;
+}
+
+uint64_t Utilities::image_checksum(const char* data, size_t size, uint64_t hash) {
+	for(size_t i = 0; i < size; i++) {
+		hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
 	}
+	return hash;
+}
 
-	//Now we do the same as above, but for the list of routes that we need to solve
-	list = file_object->find("routeList");
-	if(list && list->is_array()) {
-		JsonArray* array = list->get_array();
-		if(array->size() <= 0) {
-			claim("There are no routes in this system, this is possible but unusual",kWarning);
-		} else {
-			for(unsigned i = 0; i < array->size(); i++) {
-				JsonValue* current_value = array->at(i);
-				if(current_value->is_object()) {
-					add_connection(current_value->get_object());
-				}
-			}
-		}
+string Utilities::ProblemObject::image_filename(string filename) {
+	return filename + ".img";
+}
+
+bool Utilities::read_source_stamp(string filename, SourceStamp* stamp) {
+	struct stat info;
+	memset(stamp,0,sizeof(*stamp));
+	if(stat(filename.c_str(),&info) != 0) {
+		return false;
 	}
+	stamp->size = info.st_size;
+	stamp->mtime_sec = info.st_mtim.tv_sec;
+	stamp->mtime_nsec = info.st_mtim.tv_nsec;
+	return true;
+}
 
-	delete json_file;
-	//And now were done with a fully formed problem
+/*
+
+	Parameter filename (string): A problem file
+
+	Return type: bool, whether filename has a compiled image of this version that was
+	written from the file as it is now: same size and modification time, to the nanosecond.
+	Comparing the times for equality, rather than the image being newer, also catches a
+	file that was replaced by an older copy or changed within the timestamp resolution.
+
+*/
+bool Utilities::ProblemObject::image_is_current(string filename) {
+	SourceStamp source;
+	if(!read_source_stamp(filename,&source)) {
+		return false;
+	}
+	int fd = open(image_filename(filename).c_str(),O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+	ImageHeader header;
+	bool read_header = read(fd,&header,sizeof(header)) == (ssize_t)sizeof(header);
+	close(fd);
+	return read_header && !memcmp(header.magic,kImageMagic,sizeof(header.magic)) &&
+		header.version == kImageVersion && header.byte_order == kImageByteOrder &&
+		header.source.size == source.size && header.source.mtime_sec == source.mtime_sec &&
+		header.source.mtime_nsec == source.mtime_nsec;
 }
 
-Utilities::ProblemObject::~ProblemObject() {
-	/* Empty Destructor */
+/*
+
+	Parameter image_filename (string): Where to write the compiled image of this problem
+
+	Return type: bool, whether the image was written. It is written to a temporary file
+	and renamed into place, so a reader never sees half an image. It records the size and
+	modification time the problem file had when it was loaded; a problem that was not
+	loaded from a file gets an image that is never current.
+
+*/
+bool Utilities::ProblemObject::write_image(string image_filename) {
+	ImageHeader header;
+	memset(&header,0,sizeof(header));
+	memcpy(header.magic,kImageMagic,sizeof(header.magic));
+	header.version = kImageVersion;
+	header.byte_order = kImageByteOrder;
+	header.header_size = sizeof(ImageHeader);
+	header.flags = (this->empty_blocker_list ? kImageEmptyBlockerList : 0) |
+		(this->empty_route_list ? kImageEmptyRouteList : 0);
+	header.width = this->width;
+	header.height = this->height;
+	header.blocker_count = this->blockers.size();
+	header.connection_count = this->connections.size();
+	header.unnamed_blockers = this->unnamed_blockers;
+	header.unnamed_connections = this->unnamed_connections;
+	header.source = this->source;
+
+	string names = this->name;
+	header.name_offset = 0;
+	header.name_length = this->name.size();
+	vector<PackedBlocker> packed_blockers(this->blockers.size());
+	for(unsigned i = 0; i < this->blockers.size(); i++) {
+		const Blocker& blocker = this->blockers.at(i);
+		PackedBlocker& packed = packed_blockers.at(i);
+		packed.name_offset = names.size();
+		packed.name_length = blocker.name.size();
+		packed.x = blocker.location.x;
+		packed.y = blocker.location.y;
+		packed.width = blocker.width;
+		packed.height = blocker.height;
+		names += blocker.name;
+	}
+	vector<PackedConnection> packed_connections(this->connections.size());
+	for(unsigned i = 0; i < this->connections.size(); i++) {
+		const Connection& connection = this->connections.at(i);
+		PackedConnection& packed = packed_connections.at(i);
+		packed.name_offset = names.size();
+		packed.name_length = connection.name.size();
+		packed.source_x = connection.source.x;
+		packed.source_y = connection.source.y;
+		packed.sink_x = connection.sink.x;
+		packed.sink_y = connection.sink.y;
+		names += connection.name;
+	}
+	if(names.size() > UINT32_MAX) {
+		claim("The names of " + image_filename + " do not fit in an image",kWarning);
+		return false;
+	}
+	header.names_size = names.size();
+
+	const char* blocker_bytes = reinterpret_cast<const char*>(packed_blockers.data());
+	const char* connection_bytes = reinterpret_cast<const char*>(packed_connections.data());
+	size_t blocker_size = packed_blockers.size() * sizeof(PackedBlocker);
+	size_t connection_size = packed_connections.size() * sizeof(PackedConnection);
+	header.checksum = image_checksum(names.data(),names.size(),
+		image_checksum(connection_bytes,connection_size,image_checksum(blocker_bytes,blocker_size)));
+
+	string temporary = image_filename + ".tmp";
+	std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header),sizeof(header));
+	out.write(blocker_bytes,blocker_size);
+	out.write(connection_bytes,connection_size);
+	out.write(names.data(),names.size());
+	out.close();
+	if(!out || rename(temporary.c_str(),image_filename.c_str()) != 0) {
+		remove(temporary.c_str());
+		claim("Unable to write the problem image " + image_filename,kWarning);
+		return false;
+	}
+	return true;
 }
 
-void Utilities::ProblemObject::add_blocker(JsonObject* blocker) {
+/*
+
+	Parameter image_filename (string): A compiled image written by write_image()
+
+	Return type: bool, whether the problem was loaded. The image is mapped and its packed
+	arrays read where they lie. An image from another version or byte order, or one that
+	fails its checksum, is not loaded, so the caller falls back to the JSON file.
+
+*/
+bool Utilities::ProblemObject::load_image(string image_filename) {
+	int fd = open(image_filename.c_str(),O_RDONLY);
+	if(fd < 0) { return false; }
+	struct stat info;
+	if(fstat(fd,&info) != 0 || (size_t)info.st_size < sizeof(ImageHeader)) {
+		close(fd);
+		return false;
+	}
+	size_t size = info.st_size;
+	void* mapped = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if(mapped == MAP_FAILED) { return false; }
+	const char* data = static_cast<const char*>(mapped);
+
+	ImageHeader header;
+	memcpy(&header,data,sizeof(header));
+	size_t blocker_size = (size_t)header.blocker_count * sizeof(PackedBlocker);
+	size_t connection_size = (size_t)header.connection_count * sizeof(PackedConnection);
+	bool valid = !memcmp(header.magic,kImageMagic,sizeof(header.magic)) &&
+		header.version == kImageVersion && header.byte_order == kImageByteOrder &&
+		header.header_size == sizeof(ImageHeader) &&
+		size == sizeof(ImageHeader) + blocker_size + connection_size + header.names_size &&
+		(uint64_t)header.name_offset + header.name_length <= header.names_size;
+	if(valid) {
+		valid = image_checksum(data + sizeof(ImageHeader),size - sizeof(ImageHeader)) == header.checksum;
+	}
+	if(!valid) {
+		munmap(mapped,size);
+		claim("Ignoring the problem image " + image_filename + ", it is out of date or damaged",kWarning);
+		return false;
+	}
+
+	const PackedBlocker* packed_blockers = reinterpret_cast<const PackedBlocker*>(data + sizeof(ImageHeader));
+	const PackedConnection* packed_connections =
+		reinterpret_cast<const PackedConnection*>(data + sizeof(ImageHeader) + blocker_size);
+	const char* names = data + sizeof(ImageHeader) + blocker_size + connection_size;
+	this->name.assign(names + header.name_offset,header.name_length);
+	this->width = header.width;
+	this->height = header.height;
+	this->blockers.resize(header.blocker_count);
+	for(unsigned i = 0; i < header.blocker_count && valid; i++) {
+		const PackedBlocker& packed = packed_blockers[i];
+		valid = (uint64_t)packed.name_offset + packed.name_length <= header.names_size;
+		Blocker& blocker = this->blockers.at(i);
+		blocker.name.assign(names + (valid ? packed.name_offset : 0),valid ? packed.name_length : 0);
+		blocker.location = Point(packed.x,packed.y);
+		blocker.width = packed.width;
+		blocker.height = packed.height;
+	}
+	this->connections.resize(header.connection_count);
+	for(unsigned i = 0; i < header.connection_count && valid; i++) {
+		const PackedConnection& packed = packed_connections[i];
+		valid = (uint64_t)packed.name_offset + packed.name_length <= header.names_size;
+		Connection& connection = this->connections.at(i);
+		connection.name.assign(names + (valid ? packed.name_offset : 0),valid ? packed.name_length : 0);
+		connection.source = Point(packed.source_x,packed.source_y);
+		connection.sink = Point(packed.sink_x,packed.sink_y);
+	}
+	munmap(mapped,size);
+	if(!valid) {
+		this->blockers.clear();
+		this->connections.clear();
+		claim("Ignoring the problem image " + image_filename + ", it is out of date or damaged",kWarning);
+		return false;
+	}
+	this->empty_blocker_list = header.flags & kImageEmptyBlockerList;
+	this->empty_route_list = header.flags & kImageEmptyRouteList;
+	this->unnamed_blockers = header.unnamed_blockers;
+	this->unnamed_connections = header.unnamed_connections;
+	return true;
+}
+
+/*
+	The JSON parser keeps all of its state in a per call context, so every worker can parse
+	its own files. Problems come back in the order of filenames, owned by the caller.
+*/
+vector<Utilities::ProblemObject*> Utilities::ProblemObject::load_batch(vector<string> filenames, unsigned threads) {
+	vector<ProblemObject*> problems(filenames.size(), (ProblemObject*)NULL);
+	std::atomic<unsigned> next_file(0);
+	if(threads < 1) { threads = 1; }
+	if(threads > filenames.size()) { threads = filenames.size(); }
+	vector<std::thread> workers;
+	for(unsigned t = 0; t < threads; t++) {
+		workers.push_back(std::thread([&]() {
+			for(unsigned i = next_file++; i < filenames.size(); i = next_file++) {
+				problems.at(i) = new ProblemObject(filenames.at(i));
+			}
+		}));
+	}
+	for(unsigned t = 0; t < workers.size(); t++) {
+		workers.at(t).join();
+	}
+	return problems;
+}
+
+/* Field names of blockers and routes, hashed once for all the objects they are read from */
+static const JSON::JsonKey kNameKey("name");
+static const JSON::JsonKey kWidthKey("width");
+static const JSON::JsonKey kHeightKey("height");
+static const JSON::JsonKey kXKey("x");
+static const JSON::JsonKey kYKey("y");
+static const JSON::JsonKey kSourceXKey("source_x");
+static const JSON::JsonKey kSourceYKey("source_y");
+static const JSON::JsonKey kSinkXKey("sink_x");
+static const JSON::JsonKey kSinkYKey("sink_y");
+
+Blocker Utilities::ProblemObject::read_blocker(JsonObject* blocker) {
 	Blocker new_blocker;
-	JsonValue* blocker_name = blocker->find("name");
+	JsonValue* blocker_name = blocker->find(kNameKey);
 	if(blocker_name && blocker_name->is_string()) {
 		new_blocker.name = blocker_name->get_string();
 	} else {
 		claim("Blocker does not have a name, likely malformed JSON file",kWarning);
 	}
-	new_blocker.width = extract_int(blocker->find("width"));
-	new_blocker.height = extract_int(blocker->find("height"));
-	new_blocker.location.x = extract_int(blocker->find("x"));
-	new_blocker.location.y = extract_int(blocker->find("y"));
-	this->blockers.push_back(new_blocker);
+	new_blocker.width = extract_int(blocker->find(kWidthKey));
+	new_blocker.height = extract_int(blocker->find(kHeightKey));
+	new_blocker.location.x = extract_int(blocker->find(kXKey));
+	new_blocker.location.y = extract_int(blocker->find(kYKey));
+	return new_blocker;
 }
 
-void Utilities::ProblemObject::add_connection(JsonObject* connection) {
+Connection Utilities::ProblemObject::read_connection(JsonObject* connection) {
 	Connection new_connection;
-	JsonValue* connection_name = connection->find("name");
+	JsonValue* connection_name = connection->find(kNameKey);
 	if(connection_name && connection_name->is_string()) {
 		new_connection.name = connection_name->get_string();
 	} else {
 		claim("Connection does not have a name, likely malformed JSON file",kWarning);
 	}
-	new_connection.source.x = extract_int(connection->find("source_x"));
-	new_connection.source.y = extract_int(connection->find("source_y"));
-	new_connection.sink.x = extract_int(connection->find("sink_x"));
-	new_connection.sink.y = extract_int(connection->find("sink_y"));
-	this->connections.push_back(new_connection);
+	new_connection.source.x = extract_int(connection->find(kSourceXKey));
+	new_connection.source.y = extract_int(connection->find(kSourceYKey));
+	new_connection.sink.x = extract_int(connection->find(kSinkXKey));
+	new_connection.sink.y = extract_int(connection->find(kSinkYKey));
+	return new_connection;
 }
 
 int Utilities::ProblemObject::extract_int(JsonValue* int_value) {
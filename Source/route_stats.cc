@@ -0,0 +1,227 @@
+#include "../Headers/route_stats.h"
+#include "../Headers/claim.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+using std::ostream;
+using std::ofstream;
+using std::cout;
+using std::endl;
+
+static const char* kFieldNames[Utilities::kNumRouteFields] = {
+    "expanded", "queue_peak", "length", "bends", "expansion_ms", "backtrace_ms", "reset_ms", "print_ms"
+};
+
+static const double kFractions[] = { 0.50, 0.90, 0.99, 1.0 };
+static const char* kFractionNames[] = { "p50", "p90", "p99", "max" };
+static const unsigned kNumFractions = 4;
+
+static double field_value(const Utilities::RouteStats& stats, Utilities::RouteField field) {
+    switch (field) {
+        case Utilities::kExpanded: return stats.expanded;
+        case Utilities::kQueuePeak: return stats.queue_peak;
+        case Utilities::kLength: return stats.length;
+        case Utilities::kBends: return stats.bends;
+        case Utilities::kExpansionMs: return stats.expansion_ms;
+        case Utilities::kBacktraceMs: return stats.backtrace_ms;
+        case Utilities::kResetMs: return stats.reset_ms;
+        case Utilities::kPrintMs: return stats.print_ms;
+        default: return 0.0;
+    }
+}
+
+Utilities::RouteStats::RouteStats() {
+    this->outcome = kRouteInvalid;
+    this->expanded = 0;
+    this->queue_peak = 0;
+    this->length = 0;
+    this->bends = 0;
+    this->expansion_ms = 0.0;
+    this->backtrace_ms = 0.0;
+    this->reset_ms = 0.0;
+    this->print_ms = 0.0;
+}
+
+Utilities::RouteReport::RouteReport() {
+    /* Empty Constructor */
+}
+
+Utilities::RouteReport::~RouteReport() {
+    /* Empty Destructor */
+}
+
+unsigned Utilities::RouteReport::size() const {
+    return this->routes.size();
+}
+
+const Utilities::RouteStats& Utilities::RouteReport::at(unsigned index) const {
+    return this->routes.at(index);
+}
+
+unsigned Utilities::RouteReport::count(RouteOutcome outcome) const {
+    unsigned total = 0;
+    for (unsigned i = 0; i < this->routes.size(); i++) {
+        if (this->routes.at(i).outcome == outcome) {
+            total++;
+        }
+    }
+    return total;
+}
+
+/* The field of every connection it is taken over, see route_stats.h */
+vector<double> Utilities::RouteReport::values(RouteField field) const {
+    bool routed_only = (field == kLength || field == kBends);
+    vector<double> values;
+    for (unsigned i = 0; i < this->routes.size(); i++) {
+        RouteOutcome outcome = this->routes.at(i).outcome;
+        if (outcome == kRouted || (outcome == kRouteUnreachable && !routed_only)) {
+            values.push_back(field_value(this->routes.at(i), field));
+        }
+    }
+    return values;
+}
+
+/*
+
+    Parameter field (RouteField): Which count
+              fraction (double): Which percentile, e.g. 0.99, 1.0 for the maximum
+
+    Return double: The nearest ranked value, as RouterDaemon::percentile takes it, 0 if
+    no connection counts towards it
+
+*/
+double Utilities::RouteReport::percentile(RouteField field, double fraction) const {
+    vector<double> sorted = this->values(field);
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    unsigned rank = (unsigned)(fraction * (sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted.at(rank);
+}
+
+void Utilities::RouteReport::add(const RouteStats& stats) {
+    this->routes.push_back(stats);
+}
+
+void Utilities::RouteReport::clear() {
+    this->routes.clear();
+}
+
+/* Quotes a CSV field, doubling any quotes inside it */
+static string csv_quote(const string& text) {
+    string quoted = "\"";
+    for (unsigned i = 0; i < text.size(); i++) {
+        quoted += text[i];
+        if (text[i] == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+static void write_csv_row(ostream& out, const string& name, const string& outcome, const double* values) {
+    out << name << "," << outcome;
+    for (int f = 0; f < Utilities::kNumRouteFields; f++) {
+        out << "," << values[f];
+    }
+    out << "\n";
+}
+
+/* Pass "-" to write JSON to standard out */
+void Utilities::RouteReport::write(string filename) const {
+    ofstream file;
+    if (filename != "-") {
+        file.open(filename.c_str());
+        if (!file.is_open()) {
+            claim("Unable to open report file " + filename + " for writing", kError);
+        }
+    }
+    ostream& out = (filename == "-") ? cout : file;
+    bool csv = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+
+    double percentiles[kNumFractions][kNumRouteFields];
+    for (unsigned p = 0; p < kNumFractions; p++) {
+        for (int f = 0; f < kNumRouteFields; f++) {
+            percentiles[p][f] = this->percentile((RouteField)f, kFractions[p]);
+        }
+    }
+
+    if (csv) {
+        out << "name,outcome";
+        for (int f = 0; f < kNumRouteFields; f++) {
+            out << "," << kFieldNames[f];
+        }
+        out << "\n";
+        for (unsigned i = 0; i < this->routes.size(); i++) {
+            const RouteStats& stats = this->routes.at(i);
+            double values[kNumRouteFields];
+            for (int f = 0; f < kNumRouteFields; f++) {
+                values[f] = field_value(stats, (RouteField)f);
+            }
+            write_csv_row(out, csv_quote(stats.name), outcome_name(stats.outcome), values);
+        }
+        for (unsigned p = 0; p < kNumFractions; p++) {
+            write_csv_row(out, kFractionNames[p], "searched", percentiles[p]);
+        }
+        out.flush();
+        return;
+    }
+
+    double expansion_ms = 0.0, backtrace_ms = 0.0, reset_ms = 0.0, print_ms = 0.0;
+    for (unsigned i = 0; i < this->routes.size(); i++) {
+        expansion_ms += this->routes.at(i).expansion_ms;
+        backtrace_ms += this->routes.at(i).backtrace_ms;
+        reset_ms += this->routes.at(i).reset_ms;
+        print_ms += this->routes.at(i).print_ms;
+    }
+    out << "{" << endl;
+    out << "\t\"connections\": " << this->routes.size() << "," << endl;
+    out << "\t\"outcomes\": {\"routed\": " << this->count(kRouted) << ", \"blocked\": " << this->count(kRouteBlocked)
+        << ", \"invalid\": " << this->count(kRouteInvalid) << ", \"unreachable\": " << this->count(kRouteUnreachable) << "}," << endl;
+    out << "\t\"total_ms\": {\"expansion\": " << expansion_ms << ", \"backtrace\": " << backtrace_ms
+        << ", \"reset\": " << reset_ms << ", \"print\": " << print_ms << "}," << endl;
+    out << "\t\"percentiles\": {" << endl;
+    for (int f = 0; f < kNumRouteFields; f++) {
+        out << "\t\t\"" << kFieldNames[f] << "\": {";
+        for (unsigned p = 0; p < kNumFractions; p++) {
+            out << (p ? ", " : "") << "\"" << kFractionNames[p] << "\": " << percentiles[p][f];
+        }
+        out << "}" << (f + 1 < kNumRouteFields ? "," : "") << endl;
+    }
+    out << "\t}," << endl;
+    out << "\t\"routes\": [" << endl;
+    for (unsigned i = 0; i < this->routes.size(); i++) {
+        const RouteStats& stats = this->routes.at(i);
+        out << "\t{\"name\": " << quote_string(stats.name) << ", \"outcome\": \"" << outcome_name(stats.outcome) << "\"";
+        for (int f = 0; f < kNumRouteFields; f++) {
+            out << ", \"" << kFieldNames[f] << "\": " << field_value(stats, (RouteField)f);
+        }
+        out << "}" << (i + 1 < this->routes.size() ? "," : "") << endl;
+    }
+    out << "\t]" << endl << "}" << endl;
+}
+
+/* Turns between consecutive segments, counted rather than taken from size() in case a group was not compacted */
+unsigned Utilities::RouteReport::count_bends(const Path& path) {
+    unsigned bends = 0;
+    for (unsigned i = 1; i < path.size(); i++) {
+        bool was_vertical = path.at(i - 1).get_source().x == path.at(i - 1).get_sink().x;
+        bool is_vertical = path.at(i).get_source().x == path.at(i).get_sink().x;
+        if (was_vertical != is_vertical) {
+            bends++;
+        }
+    }
+    return bends;
+}
+
+const char* Utilities::RouteReport::outcome_name(RouteOutcome outcome) {
+    switch (outcome) {
+        case kRouted: return "routed";
+        case kRouteBlocked: return "blocked";
+        case kRouteUnreachable: return "unreachable";
+        default: return "invalid";
+    }
+}
@@ -0,0 +1,119 @@
+#include "../Headers/router_api.h"
+#include "../Headers/map.h"
+#include "../Headers/global_router.h"
+
+#include <new>
+
+using Utilities::Map;
+using Utilities::GlobalRouter;
+using Utilities::Path;
+
+struct router_map {
+    Map* map;
+    GlobalRouter* router;
+};
+
+router_map* router_map_create(int width, int height, const router_blocker* blockers, int num_blockers) {
+    if (width <= 0 || height <= 0 || num_blockers < 0 || (num_blockers > 0 && blockers == NULL)) {
+        return NULL;
+    }
+    // Validated here since Map::validate_blockers reports problems on stdout
+    vector<Blocker> map_blockers(num_blockers);
+    for (int i = 0; i < num_blockers; i++) {
+        const router_blocker& blocker = blockers[i];
+        if (blocker.x < 0 || blocker.y < 0 || blocker.width <= 0 || blocker.height <= 0 ||
+                blocker.x + blocker.width > width || blocker.y + blocker.height > height) {
+            return NULL;
+        }
+        map_blockers.at(i).location = Point(blocker.x, blocker.y);
+        map_blockers.at(i).width = blocker.width;
+        map_blockers.at(i).height = blocker.height;
+    }
+
+    router_map* handle = new (std::nothrow) router_map;
+    if (handle == NULL) {
+        return NULL;
+    }
+    try {
+        handle->map = new Map(width, height, map_blockers);
+        handle->router = new GlobalRouter(handle->map);
+    } catch (...) {
+        delete handle;
+        return NULL;
+    }
+    handle->router->set_reporting(false);
+    return handle;
+}
+
+int router_route_batch(router_map* map, const router_connection* connections, int num_connections,
+                       router_point* points, int points_capacity, int* offsets, int* status) {
+    if (map == NULL || num_connections < 0 || (num_connections > 0 && (connections == NULL || status == NULL)) ||
+            offsets == NULL || points_capacity < 0 || (points_capacity > 0 && points == NULL)) {
+        return -1;
+    }
+    // Congestion is only shared within a batch, the same batch always routes the same way
+    map->router->reset_usage();
+    int width = map->map->get_width(), height = map->map->get_height();
+    int written = 0;
+    offsets[0] = 0;
+    for (int i = 0; i < num_connections; i++) {
+        const router_connection& request = connections[i];
+        offsets[i + 1] = written;
+        // Checked up front so GlobalRouter::route is only asked for connections it can attempt
+        if (request.source_x < 0 || request.source_y < 0 || request.source_x >= width || request.source_y >= height ||
+                request.sink_x < 0 || request.sink_y < 0 || request.sink_x >= width || request.sink_y >= height ||
+                (request.source_x == request.sink_x && request.source_y == request.sink_y) ||
+                map->map->is_blocked(request.source_x, request.source_y) ||
+                map->map->is_blocked(request.sink_x, request.sink_y)) {
+            status[i] = ROUTER_INVALID;
+            continue;
+        }
+
+        Connection connection;
+        connection.source = Point(request.source_x, request.source_y);
+        connection.sink = Point(request.sink_x, request.sink_y);
+        Path path;
+        bool valid = false;
+        try {
+            valid = map->router->route(connection, &path);
+        } catch (...) {
+            valid = false;
+        }
+        if (!valid || path.empty()) {
+            status[i] = valid ? ROUTER_UNREACHABLE : ROUTER_INVALID;
+            continue;
+        }
+        int cells = path.get_length() + 1;
+        if (written + cells > points_capacity) {
+            status[i] = ROUTER_NO_SPACE;
+            continue;
+        }
+        router_point* out = points + written;
+        out->x = path.get_source().x;
+        out->y = path.get_source().y;
+        for (unsigned j = 0; j < path.size(); j++) {
+            // The path's segments are compacted, every cell along them is written out
+            Point cell = path.at(j).get_source(), end = path.at(j).get_sink();
+            int step_x = (end.x > cell.x) - (end.x < cell.x), step_y = (end.y > cell.y) - (end.y < cell.y);
+            while (!(cell == end)) {
+                cell = Point(cell.x + step_x, cell.y + step_y);
+                out++;
+                out->x = cell.x;
+                out->y = cell.y;
+            }
+        }
+        written += cells;
+        offsets[i + 1] = written;
+        status[i] = ROUTER_OK;
+    }
+    return written;
+}
+
+void router_map_free(router_map* map) {
+    if (map == NULL) {
+        return;
+    }
+    delete map->router;
+    delete map->map;
+    delete map;
+}
@@ -0,0 +1,59 @@
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+/*
+    Stand-in client for the router daemon (grid_router <test_file> --daemon <socket>).
+    Sends every line of standard in as one request and prints the response line.
+*/
+int main(int argc,char* argv[]) {
+	if(argc < 2) {
+		cout << "Usage: ./router_client <socket>" << endl;
+		exit(1);
+	}
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(server < 0 || connect(server, (sockaddr*)&address, sizeof(address)) < 0) {
+		cerr << "Error: Unable to connect to the router daemon at " << argv[1] << endl;
+		exit(1);
+	}
+
+	string request;
+	string pending;
+	char buffer[4096];
+	while(std::getline(std::cin, request)) {
+		if(request.empty()) { continue; }
+		request += "\n";
+		if(write(server, request.data(), request.size()) != (ssize_t)request.size()) {
+			cerr << "Error: Lost the connection to the router daemon" << endl;
+			exit(1);
+		}
+		//Every request gets exactly one response line
+		size_t newline;
+		while((newline = pending.find('\n')) == string::npos) {
+			ssize_t received = read(server, buffer, sizeof(buffer));
+			if(received <= 0) {
+				close(server);
+				return 0;
+			}
+			pending.append(buffer, received);
+		}
+		cout << pending.substr(0, newline) << endl;
+		pending.erase(0, newline + 1);
+	}
+	close(server);
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include "../Headers/router_daemon.h"
+#include "../Headers/eco.h"
+#include "../Headers/claim.h"
+
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using std::stringstream;
+using std::endl;
+
+Utilities::RouterDaemon::RouterDaemon(Map* map) {
+    this->map = map;
+    this->router = new GlobalRouter(map);
+    this->router->set_reporting(false);     // stdout carries the responses
+    this->shutdown = false;
+}
+
+Utilities::RouterDaemon::~RouterDaemon() {
+    delete this->router;
+}
+
+bool Utilities::RouterDaemon::is_shutdown() {
+    return this->shutdown;
+}
+
+/*
+
+    Parameter fraction (double): Which percentile to report, e.g. 0.99
+
+    Return double: That percentile of the request latencies so far, in microseconds
+
+*/
+double Utilities::RouterDaemon::percentile(double fraction) {
+    if (this->latencies.empty()) {
+        return 0.0;
+    }
+    vector<double> sorted = this->latencies;
+    unsigned rank = (unsigned)(fraction * (sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted.at(rank);
+}
+
+string Utilities::RouterDaemon::route_request(istream& args) {
+    Connection connection;
+    if (!(args >> connection.name >> connection.source.x >> connection.source.y
+               >> connection.sink.x >> connection.sink.y)) {
+        return "ERR usage: ROUTE <name> <source_x> <source_y> <sink_x> <sink_y>";
+    }
+    // A route for a name already in the solution replaces it, so its usage is given
+    // back first and the answer does not depend on how often the name was routed
+    int previous = -1;
+    for (unsigned i = 0; i < this->solution.size(); i++) {
+        if (this->solution.at(i).get_name() == connection.name) {
+            previous = i;
+            this->router->release(this->solution.at(i));
+            break;
+        }
+    }
+    Path path;
+    bool valid = this->router->route(connection, &path);
+    if (!valid || path.empty()) {
+        if (previous >= 0) {
+            this->router->charge(this->solution.at(previous));
+        }
+        return valid ? "ERR " + connection.name + " cannot be routed"
+                     : "ERR " + connection.name + " is not a valid connection";
+    }
+    CompressedPath compressed;
+    if (!compressed.encode(path)) {
+        this->router->release(path);
+        if (previous >= 0) {
+            this->router->charge(this->solution.at(previous));
+        }
+        return "ERR " + connection.name + " was not routed as one chain of segments";
+    }
+
+    stringstream response;
+    response << "OK " << connection.name << " " << path.size();
+    for (unsigned i = 0; i < path.size(); i++) {
+        Point source = path.at(i).get_source(), sink = path.at(i).get_sink();
+        response << " " << source.x << " " << source.y << " " << sink.x << " " << sink.y;
+    }
+    if (previous >= 0) {
+        this->solution.erase(this->solution.begin() + previous);
+    }
+    this->solution.push_back(std::move(compressed));
+    return response.str();
+}
+
+string Utilities::RouterDaemon::blocker_request(istream& args, bool add) {
+    Blocker blocker;
+    int width, height;
+    if (!(args >> blocker.location.x >> blocker.location.y >> width >> height)) {
+        return add ? "ERR usage: BLOCK <x> <y> <width> <height>" : "ERR usage: UNBLOCK <x> <y> <width> <height>";
+    }
+    if (width <= 0 || height <= 0) {
+        return "ERR blocker does not fit on the map";
+    }
+    blocker.width = width;
+    blocker.height = height;
+    if (!this->fits_map(blocker)) {
+        return "ERR blocker does not fit on the map";
+    }
+    // Applied as a one blocker ECO, so routes of the solution that now cross the blocker,
+    // or could not be routed before it was removed, are rerouted
+    EcoDelta delta;
+    if (add) {
+        delta.add_blocker(blocker);
+    } else {
+        delta.remove_blocker(blocker);
+    }
+    EcoDiff diff;
+    EcoRouter eco(this->map, this->router);
+    this->solution = eco.apply(std::move(this->solution), &delta, &diff);
+    stringstream response;
+    response << "OK " << eco.get_changed().size() << " " << diff.rerouted.size() << " " << diff.failed.size();
+    return response.str();
+}
+
+// Checked here, Map::validate_blockers reports on stdout which carries our responses
+bool Utilities::RouterDaemon::fits_map(const Blocker& blocker) {
+    return blocker.location.x >= 0 && blocker.location.y >= 0 && blocker.width > 0 && blocker.height > 0 &&
+           blocker.location.x + (int)blocker.width <= this->map->get_width() &&
+           blocker.location.y + (int)blocker.height <= this->map->get_height();
+}
+
+string Utilities::RouterDaemon::eco_request(istream& args) {
+    string filename;
+    if (!(args >> filename)) {
+        return "ERR usage: ECO <delta_file>";
+    }
+    EcoDelta delta;
+    if (!delta.load(filename)) {
+        return "ERR the ECO delta " + filename + " is missing or malformed";
+    }
+    vector<Blocker> added = delta.get_added_blockers();
+    for (unsigned i = 0; i < added.size(); i++) {
+        if (!this->fits_map(added.at(i))) {
+            return "ERR blocker " + added.at(i).name + " of the ECO delta does not fit on the map";
+        }
+    }
+    EcoDiff diff;
+    EcoRouter eco(this->map, this->router);
+    this->solution = eco.apply(std::move(this->solution), &delta, &diff);
+    stringstream response;
+    response << "OK " << diff.added.size() << " " << diff.removed.size() << " " << diff.rerouted.size()
+             << " " << diff.failed.size() << " " << diff.unchanged;
+    return response.str();
+}
+
+string Utilities::RouterDaemon::stats_request() {
+    stringstream response;
+    response << "OK " << this->latencies.size() << " " << this->percentile(0.50) << " " << this->percentile(0.99);
+    return response.str();
+}
+
+/*
+
+    Parameter request (string): One request line, without its newline
+              close (bool*): Set when the client asked for the connection to be closed
+
+    Return string: The response line, without its newline. The time spent is recorded
+    for the latency percentiles.
+
+*/
+string Utilities::RouterDaemon::handle(const string& request, bool* close) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    stringstream args(request);
+    string command;
+    string response;
+    *close = false;
+    args >> command;
+    if (command == "ROUTE") {
+        response = this->route_request(args);
+    } else if (command == "BLOCK" || command == "UNBLOCK") {
+        response = this->blocker_request(args, command == "BLOCK");
+    } else if (command == "ECO") {
+        response = this->eco_request(args);
+    } else if (command == "STATS") {
+        response = this->stats_request();
+    } else if (command == "QUIT" || command == "SHUTDOWN") {
+        this->shutdown = (command == "SHUTDOWN");
+        *close = true;
+        response = "OK";
+    } else {
+        response = "ERR unknown request " + command;
+    }
+    this->latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    return response;
+}
+
+// Answers requests from a stream (e.g. stdin/stdout) until QUIT, SHUTDOWN or end of input
+void Utilities::RouterDaemon::serve(istream& in, ostream& out) {
+    string line;
+    bool close = false;
+    while (!close && std::getline(in, line)) {
+        if (line.empty()) { continue; }
+        out << this->handle(line, &close) << endl;
+    }
+}
+
+static bool write_all(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+/*
+
+    Parameter socket_path (string): Where to create the Unix domain socket
+
+    Accepts one client at a time and answers its requests until it sends QUIT or hangs
+    up, then waits for the next client, until a client sends SHUTDOWN.
+
+*/
+void Utilities::RouterDaemon::serve_socket(string socket_path) {
+    sockaddr_un address;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        claim("Socket path " + socket_path + " is too long", kError);
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        claim("Unable to create the daemon socket", kError);
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(socket_path.c_str());
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 8) < 0) {
+        close(listener);
+        claim("Unable to listen on " + socket_path, kError);
+    }
+    claim("Router daemon listening on " + socket_path, kNote);
+
+    char buffer[4096];
+    while (!this->shutdown) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR) { continue; }
+            claim("Daemon failed to accept a client", kWarning);
+            break;
+        }
+        string pending;
+        bool close_client = false;
+        while (!close_client) {
+            ssize_t received = read(client, buffer, sizeof(buffer));
+            if (received < 0 && errno == EINTR) { continue; }
+            if (received <= 0) { break; }
+            pending.append(buffer, received);
+            size_t newline;
+            while (!close_client && (newline = pending.find('\n')) != string::npos) {
+                string line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (!line.empty() && line.at(line.size() - 1) == '\r') { line.erase(line.size() - 1); }
+                if (line.empty()) { continue; }
+                if (!write_all(client, this->handle(line, &close_client) + "\n")) {
+                    close_client = true;
+                }
+            }
+        }
+        close(client);
+    }
+    close(listener);
+    unlink(socket_path.c_str());
+}
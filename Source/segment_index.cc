@@ -0,0 +1,102 @@
+#include "../Headers/segment_index.h"
+
+#include <algorithm>
+#include <climits>
+
+using std::min;
+using std::max;
+
+Utilities::SegmentIndex::SegmentIndex() {
+    /* Empty Constructor */
+}
+
+Utilities::SegmentIndex::~SegmentIndex() {
+    /* Empty Destructor */
+}
+
+/* Adds cells lo to hi of line, merged with the runs of that line they overlap or touch */
+void Utilities::SegmentIndex::add_run(set<Run>* runs, int line, int lo, int hi) {
+    Run probe = { line, lo, hi };
+    set<Run>::iterator it = runs->upper_bound(probe);
+    if (it != runs->begin()) {
+        set<Run>::iterator before = std::prev(it);
+        if (before->line == line && before->hi >= lo - 1) {
+            if (before->hi >= hi) {
+                return;
+            }
+            lo = before->lo;
+            runs->erase(before);
+        }
+    }
+    while (it != runs->end() && it->line == line && it->lo <= hi + 1) {
+        hi = max(hi, it->hi);
+        it = runs->erase(it);
+    }
+    Run run = { line, lo, hi };
+    runs->insert(it, run);
+}
+
+/* Whether any run of line shares a cell with lo to hi, only the run starting last at or before hi can */
+bool Utilities::SegmentIndex::covers(const set<Run>& runs, int line, int lo, int hi) {
+    Run probe = { line, hi, hi };
+    set<Run>::const_iterator it = runs.upper_bound(probe);
+    if (it == runs.begin()) {
+        return false;
+    }
+    --it;
+    return it->line == line && it->hi >= lo;
+}
+
+/* Whether any run on the lines first_line to last_line covers the cell at on its line */
+bool Utilities::SegmentIndex::crosses(const set<Run>& runs, int first_line, int last_line, int at) {
+    Run probe = { first_line, INT_MIN, INT_MIN };
+    for (set<Run>::const_iterator it = runs.lower_bound(probe); it != runs.end() && it->line <= last_line; ++it) {
+        if (it->lo <= at && it->hi >= at) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Utilities::SegmentIndex::contains(const Point& point) const {
+    return covers(this->rows, point.y, point.x, point.x) || covers(this->columns, point.x, point.y, point.y);
+}
+
+/*
+
+    Parameter source, sink (Point): A straight segment
+
+    Return bool: Whether the segment shares a cell with the indexed segments. A segment
+    that is not straight is never found to intersect, SegmentGroup checks those itself.
+
+*/
+bool Utilities::SegmentIndex::intersects(Point source, Point sink) const {
+    int x1 = min(source.x, sink.x), x2 = max(source.x, sink.x);
+    int y1 = min(source.y, sink.y), y2 = max(source.y, sink.y);
+    if (y1 == y2) {
+        return covers(this->rows, y1, x1, x2) || crosses(this->columns, x1, x2, y1);
+    }
+    if (x1 == x2) {
+        return covers(this->columns, x1, y1, y2) || crosses(this->rows, y1, y2, x1);
+    }
+    return false;
+}
+
+/* Number of runs, after merging */
+unsigned Utilities::SegmentIndex::size() const {
+    return this->rows.size() + this->columns.size();
+}
+
+/* Adds a straight segment, in either direction. A single cell goes in with the rows */
+void Utilities::SegmentIndex::add(Point source, Point sink) {
+    if (source.y == sink.y) {
+        add_run(&this->rows, source.y, min(source.x, sink.x), max(source.x, sink.x));
+    } else {
+        add_run(&this->columns, source.x, min(source.y, sink.y), max(source.y, sink.y));
+    }
+}
+
+void Utilities::SegmentIndex::clear() {
+    this->rows.clear();
+    this->columns.clear();
+}
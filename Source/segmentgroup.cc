@@ -2,11 +2,12 @@
 #include "../Headers/claim.h"
 
 #include <iostream>
+#include <utility>
 
 using std::cout;
 using std::endl;
 
-bool Utilities::SegmentGroup::on_segment(Point p1,Point p2,Point p3) {
+bool Utilities::SegmentGroup::on_segment(Point p1,Point p2,Point p3) const {
     if((p2.x <= std::max(p1.x,p3.x) && p2.x >= std::min(p1.x,p3.x)) &&
             (p2.y <= std::max(p1.y,p3.y) && p2.y >= std::min(p1.y,p3.y))) {
         return true;
@@ -14,15 +15,72 @@ bool Utilities::SegmentGroup::on_segment(Point p1,Point p2,Point p3) {
     return false;
 }
 
+static inline int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+/* Folds source -> sink into the last segment if it continues it in the same direction */
+bool Utilities::SegmentGroup::extends_last(Point source, Point sink) {
+    if(this->segments.empty() || source == sink) {
+        return false;
+    }
+    PathSegment& last = this->segments.back();
+    Point last_source = last.get_source(), last_sink = last.get_sink();
+    if(sign(sink.x - source.x) != sign(last_sink.x - last_source.x) ||
+            sign(sink.y - source.y) != sign(last_sink.y - last_source.y)) {
+        return false;
+    }
+    if(source == last_sink) {               // built from source to sink
+        last.set_sink(sink);
+        return true;
+    }
+    if(sink == last_source) {               // built backwards, as lee's backtrace does
+        last.set_source(source);
+        return true;
+    }
+    return false;
+}
+
 Utilities::SegmentGroup::SegmentGroup() {
-    /* Empty Constructor */
+    this->index = NULL;
+}
+
+Utilities::SegmentGroup::SegmentGroup(const SegmentGroup& other): segments(other.segments) {
+    this->index = other.index ? new SegmentIndex(*other.index) : NULL;
+}
+
+Utilities::SegmentGroup::SegmentGroup(SegmentGroup&& other): segments(std::move(other.segments)) {
+    this->index = other.index;
+    other.index = NULL;
+}
+
+Utilities::SegmentGroup& Utilities::SegmentGroup::operator=(const SegmentGroup& other) {
+    if(this != &other) {
+        this->segments = other.segments;
+        delete this->index;
+        this->index = other.index ? new SegmentIndex(*other.index) : NULL;
+    }
+    return *this;
+}
+
+Utilities::SegmentGroup& Utilities::SegmentGroup::operator=(SegmentGroup&& other) {
+    if(this != &other) {
+        this->segments = std::move(other.segments);
+        delete this->index;
+        this->index = other.index;
+        other.index = NULL;
+    }
+    return *this;
 }
 
 Utilities::SegmentGroup::~SegmentGroup() {
-    while(!this->segments.empty()) {
-        PathSegment* temp = this->segments.back();
-        segments.pop_back();
-        delete(temp);
+    delete this->index;
+}
+
+/* Keeps the index, if there is one, up to date with a segment that was just added */
+void Utilities::SegmentGroup::index_segment(Point source, Point sink) {
+    if(this->index) {
+        this->index->add(source, sink);
     }
 }
 
@@ -30,7 +88,7 @@ unsigned Utilities::SegmentGroup::size() const {
     return this->segments.size();
 }
 
-PathSegment* Utilities::SegmentGroup::at(unsigned index) const { 
+const PathSegment& Utilities::SegmentGroup::at(unsigned index) const { 
     return this->segments.at(index); 
 }
 
@@ -38,29 +96,60 @@ bool Utilities::SegmentGroup::empty() const {
     return this->segments.empty();
 }
 
-bool Utilities::SegmentGroup::contains(const Point& point) {
+bool Utilities::SegmentGroup::contains(const Point& point) const {
+    if(this->index) {
+        return this->index->contains(point);
+    }
     for(unsigned i = 0; i < this->segments.size(); i++) {
-        if(on_segment(segments.at(i)->get_source(),segments.at(i)->get_sink(),point)) {
+        if(on_segment(segments.at(i).get_source(),point,segments.at(i).get_sink())) {
             return true;
         }
     }
     return false;
 }
 
-int Utilities::SegmentGroup::get_length() {
+/*
+
+    Parameter source, sink (Point): A segment to test against the group
+
+    Return bool: Whether it shares a cell with any segment of the group. Without an index,
+    or if the segment is not straight, each segment's bounding box is tested against it.
+
+*/
+bool Utilities::SegmentGroup::intersects(Point source, Point sink) const {
+    int x1 = std::min(source.x, sink.x), x2 = std::max(source.x, sink.x);
+    int y1 = std::min(source.y, sink.y), y2 = std::max(source.y, sink.y);
+    if(this->index && (x1 == x2 || y1 == y2)) {
+        return this->index->intersects(source, sink);
+    }
+    for(unsigned i = 0; i < this->segments.size(); i++) {
+        Point p1 = this->segments.at(i).get_source(), p2 = this->segments.at(i).get_sink();
+        if(x1 <= std::max(p1.x,p2.x) && x2 >= std::min(p1.x,p2.x) &&
+                y1 <= std::max(p1.y,p2.y) && y2 >= std::min(p1.y,p2.y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Utilities::SegmentGroup::is_indexed() const {
+    return this->index != NULL;
+}
+
+int Utilities::SegmentGroup::get_length() const {
     int total_length = 0;
-    for(int i = 0; i < this->segments.size(); i++) {
-        total_length += this->segments.at(i)->get_length();
+    for(unsigned i = 0; i < this->segments.size(); i++) {
+        total_length += this->segments.at(i).get_length();
     }
     return total_length;
 }
 
-void Utilities::SegmentGroup::print() {
+void Utilities::SegmentGroup::print() const {
     if(this->segments.size() <= 0) {
         return;
     }
     for(unsigned i = 0; i < this->segments.size(); i++) {
-        this->segments.at(i)->print();
+        this->segments.at(i).print();
         if(i < this->segments.size() -1) {
             cout << " | ";
         }
@@ -68,45 +157,67 @@ void Utilities::SegmentGroup::print() {
     cout << endl;
 }
 
-void Utilities::SegmentGroup::add_segment(PathSegment* pathsegment) {
-    this->segments.push_back(pathsegment);
+/* Indexes the segments so far, add_segment keeps the index up to date from then on */
+void Utilities::SegmentGroup::build_index() {
+    if(!this->index) {
+        this->index = new SegmentIndex();
+    }
+    this->index->clear();
+    for(unsigned i = 0; i < this->segments.size(); i++) {
+        this->index_segment(this->segments.at(i).get_source(), this->segments.at(i).get_sink());
+    }
+}
+
+void Utilities::SegmentGroup::drop_index() {
+    delete this->index;
+    this->index = NULL;
+}
+
+/* Makes room for a number of segments up front, for routers that know how long the path is */
+void Utilities::SegmentGroup::reserve(unsigned segments) {
+    this->segments.reserve(segments);
+}
+
+/* A segment folded into the last one is indexed as it was given, its cells are the same */
+void Utilities::SegmentGroup::add_segment(const PathSegment& pathsegment) {
+    if(!this->extends_last(pathsegment.get_source(), pathsegment.get_sink())) {
+        this->segments.push_back(pathsegment);
+    }
+    this->index_segment(pathsegment.get_source(), pathsegment.get_sink());
 }
 
 void Utilities::SegmentGroup::add_segment(Point source, Point sink) {
-    this->segments.push_back(new PathSegment(source, sink));
+    if(!this->extends_last(source, sink)) {
+        this->segments.push_back(PathSegment(source, sink));
+    }
+    this->index_segment(source, sink);
 }
 
 /* Note: if the pathsegment appears multiple times in the path, all instances will be removed */
-void Utilities::SegmentGroup::remove_segment(PathSegment* pathsegment) {
-    for(vector<PathSegment*>::iterator it = this->segments.begin(); it != this->segments.end(); it++) {
-        if((*it) == pathsegment) {
-            this->segments.erase(it);
-            if(it == this->segments.end()) { break; }
-        }
-    }
-    delete pathsegment;
+void Utilities::SegmentGroup::remove_segment(const PathSegment& pathsegment) {
+    this->remove_segment(pathsegment.get_source(), pathsegment.get_sink());
 }
 
 /* Note: if the pathsegment appears multiple times in the path, all instances will be removed */
 void Utilities::SegmentGroup::remove_segment(Point source, Point sink) {
-    PathSegment* to_delete;
-    for(vector<PathSegment*>::iterator it = this->segments.begin(); it != this->segments.end(); it++) {
-        if((*it)->get_source() == source && (*it)->get_sink() == sink) {
-            to_delete = (*it);
-            this->segments.erase(it);
-            if(it == this->segments.end()) { break; }
+    vector<PathSegment>::iterator kept = this->segments.begin();
+    for(vector<PathSegment>::iterator it = this->segments.begin(); it != this->segments.end(); it++) {
+        if(!it->contains_points(source, sink)) {
+            *kept++ = *it;
         }
     }
-    if(to_delete != NULL) { delete to_delete; }
+    this->segments.erase(kept, this->segments.end());
+    if(this->index) {
+        this->build_index();
+    }
 }
 
 void Utilities::SegmentGroup::remove_segment(int index) {
-    if(index >= this->segments.size()) {
+    if(index < 0 || index >= (int)this->segments.size()) {
         claim("Attempting to remove segment with index out of range of the paths size", kError);
     }
-    vector<PathSegment*>::iterator it = this->segments.begin();
-    it += index;
-    PathSegment* to_remove = *it;       //TODO: Double check that this *it is correct
-    this->segments.erase(it);
-    delete to_remove;
+    this->segments.erase(this->segments.begin() + index);
+    if(this->index) {
+        this->build_index();
+    }
 }
@@ -0,0 +1,409 @@
+#include "../Headers/solution.h"
+#include "../Headers/problem_object.h"
+#include "../Headers/claim.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::cout;
+
+// Longest text an int can turn into, and a bound on what one segment adds in either format
+static const size_t kIntChars = 11;
+static const size_t kSegmentChars = 4 * kIntChars + 16;
+static const size_t kPathChars = 4 * kIntChars + 96;
+
+/* Digits are produced backwards into a small scratch array, then copied to out */
+static inline char* put_int(char* out, int value) {
+    char digits[kIntChars];
+    char* end = digits + kIntChars;
+    char* begin = end;
+    unsigned magnitude = (value < 0) ? 0u - (unsigned)value : (unsigned)value;
+    do {
+        *--begin = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        *--begin = '-';
+    }
+    memcpy(out, begin, end - begin);
+    return out + (end - begin);
+}
+
+static inline char* put_text(char* out, const char* text, size_t length) {
+    memcpy(out, text, length);
+    return out + length;
+}
+
+#define PUT_LITERAL(out, text) put_text(out, text, sizeof(text) - 1)
+
+static inline char* put_point(char* out, Point point) {
+    *out++ = '(';
+    out = put_int(out, point.x);
+    *out++ = ',';
+    out = put_int(out, point.y);
+    *out++ = ')';
+    return out;
+}
+
+/* An upper bound on the text of a whole solution, so the buffer is sized once per solution */
+static size_t solution_bound(const vector<Path>& paths) {
+    size_t bound = 2 * kPathChars;
+    for (unsigned i = 0; i < paths.size(); i++) {
+        bound += kPathChars + paths.at(i).get_name().size() + paths.at(i).size() * kSegmentChars;
+    }
+    return bound;
+}
+
+Utilities::SolutionWriter::SolutionWriter() {
+    this->buffer = NULL;
+    this->capacity = 0;
+    this->used = 0;
+}
+
+Utilities::SolutionWriter::~SolutionWriter() {
+    delete[] this->buffer;
+}
+
+/*
+    Grows the buffer, if need be, so bytes more can be formatted, and returns where they go.
+    The new buffer is left uninitialised, only the pages that are written to get touched.
+*/
+char* Utilities::SolutionWriter::make_room(size_t bytes) {
+    if (this->used + bytes > this->capacity) {
+        size_t capacity = std::max(this->capacity * 2, this->used + bytes);
+        char* grown = new char[capacity];
+        if (this->used > 0) {
+            memcpy(grown, this->buffer, this->used);
+        }
+        delete[] this->buffer;
+        this->buffer = grown;
+        this->capacity = capacity;
+    }
+    return this->buffer + this->used;
+}
+
+/*
+
+    Parameter index (unsigned): The number the path is printed under
+              path (const Path&): The route to format
+
+    Appends the route as grid_router has always printed it: its segments separated by
+    " | ", then the sanity check line with its length in cells. Before segments were merged
+    that was also their number, which is what it printed.
+
+*/
+void Utilities::SolutionWriter::format_text(unsigned index, const Path& path) {
+    unsigned segments = path.size();
+    char* start = this->make_room(kPathChars + segments * kSegmentChars);
+    char* out = PUT_LITERAL(start, "Path ");
+    out = put_int(out, index);
+    out = PUT_LITERAL(out, ": ");
+    for (unsigned j = 0; j < segments; j++) {
+        const PathSegment& segment = path.at(j);
+        if (j) { out = PUT_LITERAL(out, " | "); }
+        out = put_point(out, segment.get_source());
+        out = PUT_LITERAL(out, " -> ");
+        out = put_point(out, segment.get_sink());
+    }
+    if (segments > 0) { *out++ = '\n'; }
+    out = PUT_LITERAL(out, "Path length: ");
+    out = put_int(out, path.get_length());
+    out = PUT_LITERAL(out, " (sanity check)\n\n");
+    this->used += out - start;
+}
+
+void Utilities::SolutionWriter::format_text(const vector<Path>& paths) {
+    this->make_room(solution_bound(paths));
+    for (unsigned i = 0; i < paths.size(); i++) {
+        this->format_text(i, paths.at(i));
+    }
+}
+
+void Utilities::SolutionWriter::begin_json() {
+    char* start = this->make_room(kPathChars);
+    this->used += PUT_LITERAL(start, "{\n\t\"routes\": [\n") - start;
+}
+
+/*
+
+    Parameter path (const Path&): The route to format
+              first (bool): Whether it is the first route of the solution, every other
+                            one is separated from the one before by a comma
+
+    Appends the route in the JSON layout described in solution.h, which read_solution
+    takes back in.
+
+*/
+void Utilities::SolutionWriter::format_json(const Path& path, bool first) {
+    string name = quote_string(path.get_name());
+    unsigned segments = path.size();
+    char* start = this->make_room(kPathChars + name.size() + segments * kSegmentChars);
+    char* out = first ? start : PUT_LITERAL(start, ",\n");
+    out = PUT_LITERAL(out, "\t{\"name\": ");
+    out = put_text(out, name.data(), name.size());
+    out = PUT_LITERAL(out, ", \"source_x\": ");
+    out = put_int(out, path.get_source().x);
+    out = PUT_LITERAL(out, ", \"source_y\": ");
+    out = put_int(out, path.get_source().y);
+    out = PUT_LITERAL(out, ", \"sink_x\": ");
+    out = put_int(out, path.get_sink().x);
+    out = PUT_LITERAL(out, ", \"sink_y\": ");
+    out = put_int(out, path.get_sink().y);
+    out = PUT_LITERAL(out, ", \"segments\": [");
+    for (unsigned j = 0; j < segments; j++) {
+        const PathSegment& segment = path.at(j);
+        Point source = segment.get_source();
+        Point sink = segment.get_sink();
+        out = j ? PUT_LITERAL(out, ", [") : PUT_LITERAL(out, "[");
+        out = put_int(out, source.x);
+        *out++ = ',';
+        out = put_int(out, source.y);
+        *out++ = ',';
+        out = put_int(out, sink.x);
+        *out++ = ',';
+        out = put_int(out, sink.y);
+        *out++ = ']';
+    }
+    out = PUT_LITERAL(out, "]}");
+    this->used += out - start;
+}
+
+/* Closes the routes list, any tells whether a route was formatted since begin_json() */
+void Utilities::SolutionWriter::end_json(bool any) {
+    char* start = this->make_room(kPathChars);
+    char* out = any ? PUT_LITERAL(start, "\n") : start;
+    this->used += PUT_LITERAL(out, "\t]\n}\n") - start;
+}
+
+void Utilities::SolutionWriter::format_json(const vector<Path>& paths) {
+    this->make_room(solution_bound(paths));
+    this->begin_json();
+    for (unsigned i = 0; i < paths.size(); i++) {
+        this->format_json(paths.at(i), i == 0);
+    }
+    this->end_json(!paths.empty());
+}
+
+/* Hands the whole buffer to the file, or standard out for "-", and empties it for the next solution */
+void Utilities::SolutionWriter::flush(string filename) {
+    if (filename == "-") {
+        this->write_to(STDOUT_FILENO, filename);
+        return;
+    }
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        claim("Unable to open solution file " + filename + " for writing", kError);
+    }
+    this->write_to(fd, filename);
+    close(fd);
+}
+
+/*
+
+    Parameter fd (int): An open file to append what has been formatted to
+              filename (string): Its name, for the error message
+
+    Writes and empties the buffer. Whatever cout and stdio still hold is flushed first
+    when fd is standard out, it was printed before what is in the buffer.
+
+*/
+void Utilities::SolutionWriter::write_to(int fd, string filename) {
+    if (fd == STDOUT_FILENO) {
+        cout.flush();
+        fflush(stdout);
+    }
+    const char* data = this->buffer;
+    size_t remaining = this->used;
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0 && errno == EINTR) { continue; }
+        if (written <= 0) {
+            claim("Unable to write the solution to " + filename, kError);
+        }
+        data += written;
+        remaining -= written;
+    }
+    this->used = 0;
+}
+
+void Utilities::SolutionWriter::write_text(string filename, const vector<Path>& paths) {
+    this->used = 0;
+    this->format_text(paths);
+    this->flush(filename);
+}
+
+void Utilities::SolutionWriter::write_json(string filename, const vector<Path>& paths) {
+    this->used = 0;
+    this->format_json(paths);
+    this->flush(filename);
+}
+
+/* What has been formatted and not yet written */
+const char* Utilities::SolutionWriter::data() const {
+    return this->buffer;
+}
+
+size_t Utilities::SolutionWriter::size() const {
+    return this->used;
+}
+
+Utilities::SolutionStream::SolutionStream(string json_file, string binary_file) {
+    this->json_file = json_file;
+    this->binary_file = binary_file;
+    this->json_fd = -1;
+    this->count = 0;
+    if (!json_file.empty()) {
+        this->json.begin_json();
+    }
+}
+
+Utilities::SolutionStream::~SolutionStream() {
+    if (this->json_fd >= 0) {
+        close(this->json_fd);
+    }
+}
+
+/* Writes out the JSON buffered so far, JSON for standard out only once the last of it is in */
+void Utilities::SolutionStream::write_json(bool last) {
+    if (this->json_file == "-") {
+        if (last) {
+            this->json.write_to(STDOUT_FILENO, this->json_file);
+        }
+        return;
+    }
+    if (this->json_fd < 0) {
+        this->json_fd = open(this->json_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (this->json_fd < 0) {
+            claim("Unable to open solution file " + this->json_file + " for writing", kError);
+            return;
+        }
+    }
+    this->json.write_to(this->json_fd, this->json_file);
+}
+
+/* Formats the path into the outputs that were asked for, the path itself is not kept */
+void Utilities::SolutionStream::path_ready(Path& path) {
+    this->text.format_text(this->count, path);
+    if (this->text.size() >= kStreamFlushSize) {
+        this->text.write_to(STDOUT_FILENO, "-");
+    }
+    if (!this->json_file.empty()) {
+        this->json.format_json(path, this->count == 0);
+        if (this->json.size() >= kStreamFlushSize) {
+            this->write_json(false);
+        }
+    }
+    if (!this->binary_file.empty()) {
+        this->image.add(path);
+    }
+    this->count++;
+}
+
+/* Writes whatever is still buffered, closes the JSON solution and writes the binary one */
+void Utilities::SolutionStream::finish() {
+    if (!this->json_file.empty()) {
+        this->json.end_json(this->count > 0);
+        this->write_json(true);
+        if (this->json_fd >= 0) {
+            close(this->json_fd);
+            this->json_fd = -1;
+        }
+    }
+    if (!this->binary_file.empty()) {
+        this->image.write(this->binary_file);
+    }
+    this->text.write_to(STDOUT_FILENO, "-");
+}
+
+/* Paths handed over so far */
+unsigned Utilities::SolutionStream::size() const {
+    return this->count;
+}
+
+void Utilities::write_solution(string filename, const vector<Path>& paths) {
+    SolutionWriter writer;
+    writer.write_json(filename, paths);
+}
+
+// JsonValue::get_int gives 0 for anything that is not an integer, so coordinates are checked first
+static bool is_int_value(JsonValue* value) {
+    return value != NULL && value->is_int();
+}
+
+/*
+
+    Parameter filename (string): A solution written by write_solution
+
+    Return vector<Path>: The routes of the solution. Routes whose end points are not
+    integers and malformed segments are skipped with a warning, a file without a routes
+    list is an error.
+    A binary solution is read with SolutionImageReader instead of the JSON parser.
+
+*/
+vector<Path> Utilities::read_solution(string filename) {
+    if (SolutionImageReader::is_solution_image(filename)) {
+        SolutionImageReader reader;
+        if (!reader.open(filename)) {
+            claim("The binary solution " + filename + " could not be read", kError);
+        }
+        vector<Path> paths;
+        paths.reserve(reader.size());
+        Path path;
+        while (reader.next(&path)) {
+            paths.push_back(std::move(path));
+        }
+        return paths;
+    }
+
+    JSON::JsonFile* json_file = new JSON::JsonFile();
+    json_parse(filename, json_file);
+    if (json_file->objects_size() < 1) {
+        claim("The solution " + filename + " has no objects, it is missing or malformed", kError);
+    }
+
+    vector<Path> paths;
+    JsonValue* list = json_file->objects_at(0)->find("routes");
+    if (!list || !list->is_array()) {
+        claim("The solution " + filename + " does not have a routes list", kError);
+    }
+    JsonArray* routes = list->get_array();
+    for (unsigned i = 0; i < routes->size(); i++) {
+        if (!routes->at(i)->is_object()) { continue; }
+        JsonObject* route = routes->at(i)->get_object();
+        Connection connection = ProblemObject::read_connection(route);
+        if (!is_int_value(route->find("source_x")) || !is_int_value(route->find("source_y")) ||
+                !is_int_value(route->find("sink_x")) || !is_int_value(route->find("sink_y"))) {
+            claim("Route " + connection.name + " of " + filename + " does not have integer end points, skipping it",
+                  kWarning);
+            continue;
+        }
+        Path path;
+        path.set_name(connection.name);
+        path.set_source(connection.source);
+        path.set_sink(connection.sink);
+
+        JsonValue* segments = route->find("segments");
+        if (segments && segments->is_array()) {
+            path.reserve(segments->get_array()->size());
+            for (unsigned j = 0; j < segments->get_array()->size(); j++) {
+                JsonValue* segment = segments->get_array()->at(j);
+                JsonArray* ends = segment->is_array() ? segment->get_array() : NULL;
+                if (!ends || ends->size() != 4 || !is_int_value(ends->at(0)) || !is_int_value(ends->at(1)) ||
+                        !is_int_value(ends->at(2)) || !is_int_value(ends->at(3))) {
+                    claim("Route " + connection.name + " has a malformed segment, skipping it", kWarning);
+                    continue;
+                }
+                path.add_segment(Point(ends->at(0)->get_int(), ends->at(1)->get_int()),
+                                 Point(ends->at(2)->get_int(), ends->at(3)->get_int()));
+            }
+        }
+        paths.push_back(std::move(path));
+    }
+    delete json_file;
+    return paths;
+}
@@ -0,0 +1,426 @@
+#include "../Headers/solution.h"
+#include "../Headers/solution_image.h"
+#include "../Headers/problem_image.h"
+#include "../Headers/claim.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Zigzag maps small negative and positive deltas alike onto small unsigned values */
+static inline void put_varint(string* out, int value) {
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    while (zigzag >= 0x80) {
+        *out += (char)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out += (char)zigzag;
+}
+
+static inline bool get_varint(const uint8_t** at, const uint8_t* end, int* value) {
+    uint32_t zigzag = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*at == end) {
+            return false;
+        }
+        uint8_t byte = *(*at)++;
+        zigzag |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = (int)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+            return true;
+        }
+    }
+    return false;
+}
+
+// A straight segment's extent as one value, see solution_image.h
+static inline int step_of(Point from, Point to) {
+    return (to.x != from.x) ? (to.x - from.x) * 2 : (to.y - from.y) * 2 + 1;
+}
+
+static inline Point apply_step(Point from, int step) {
+    int length = (step - (step & 1)) / 2;
+    return (step & 1) ? Point(from.x, from.y + length) : Point(from.x + length, from.y);
+}
+
+// Which way, if any, the segments of path hang together
+static int chain_form(const Path& path) {
+    bool forwards = true, backwards = true;
+    for (unsigned i = 1; i < path.size() && (forwards || backwards); i++) {
+        forwards = forwards && path.at(i).get_source() == path.at(i - 1).get_sink();
+        backwards = backwards && path.at(i).get_sink() == path.at(i - 1).get_source();
+    }
+    return forwards ? Utilities::kChainForwards : backwards ? Utilities::kChainBackwards : Utilities::kChainNone;
+}
+
+static void encode_route(string* data, const Path& path) {
+    Point source = path.get_source(), sink = path.get_sink();
+    int form = chain_form(path);
+    put_varint(data, path.size());
+    put_varint(data, form);
+    put_varint(data, source.x);
+    put_varint(data, source.y);
+    put_varint(data, sink.x - source.x);
+    put_varint(data, sink.y - source.y);
+    if (path.empty()) {
+        return;
+    }
+    if (form == Utilities::kChainForwards) {
+        Point start = path.at(0).get_source();
+        put_varint(data, start.x - source.x);
+        put_varint(data, start.y - source.y);
+        for (unsigned i = 0; i < path.size(); i++) {
+            put_varint(data, step_of(path.at(i).get_source(), path.at(i).get_sink()));
+        }
+    } else if (form == Utilities::kChainBackwards) {
+        Point start = path.at(0).get_sink();
+        put_varint(data, start.x - sink.x);
+        put_varint(data, start.y - sink.y);
+        for (unsigned i = 0; i < path.size(); i++) {
+            put_varint(data, step_of(path.at(i).get_sink(), path.at(i).get_source()));
+        }
+    } else {
+        Point previous = source;
+        for (unsigned i = 0; i < path.size(); i++) {
+            Point segment_source = path.at(i).get_source(), segment_sink = path.at(i).get_sink();
+            put_varint(data, segment_source.x - previous.x);
+            put_varint(data, segment_source.y - previous.y);
+            put_varint(data, segment_sink.x - segment_source.x);
+            put_varint(data, segment_sink.y - segment_source.y);
+            previous = segment_sink;
+        }
+    }
+}
+
+Utilities::SolutionImageWriter::SolutionImageWriter() {
+    /* Empty Constructor */
+}
+
+Utilities::SolutionImageWriter::~SolutionImageWriter() {
+    /* Empty Destructor */
+}
+
+void Utilities::SolutionImageWriter::add(const Path& path) {
+    string name = path.get_name();
+    PackedRoute packed;
+    packed.name_offset = this->names.size();
+    packed.name_length = name.size();
+    packed.data_offset = this->data.size();
+    this->routes.push_back(packed);
+    this->names += name;
+    encode_route(&this->data, path);
+}
+
+unsigned Utilities::SolutionImageWriter::size() const {
+    return this->routes.size();
+}
+
+/*
+
+    Parameter filename (string): Where to write the binary solution
+
+    Return bool: Whether the solution was written. Like a problem image it is written to
+    a temporary file and renamed into place, so a reader never sees half a solution.
+
+*/
+bool Utilities::SolutionImageWriter::write(string filename) {
+    SolutionHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kSolutionMagic, sizeof(header.magic));
+    header.version = kSolutionVersion;
+    header.byte_order = kSolutionByteOrder;
+    header.header_size = sizeof(SolutionHeader);
+    header.route_count = this->routes.size();
+    if (this->names.size() > UINT32_MAX) {
+        claim("The names of " + filename + " do not fit in a binary solution", kWarning);
+        return false;
+    }
+    header.names_size = this->names.size();
+    header.data_size = this->data.size();
+
+    // Same order as std::string::compare, which SolutionImageReader::find searches by
+    const string& names = this->names;
+    const vector<PackedRoute>& routes = this->routes;
+    vector<uint32_t> name_order(routes.size());
+    for (unsigned i = 0; i < name_order.size(); i++) {
+        name_order.at(i) = i;
+    }
+    std::stable_sort(name_order.begin(), name_order.end(), [&](uint32_t a, uint32_t b) {
+        return names.compare(routes.at(a).name_offset, routes.at(a).name_length,
+                             names, routes.at(b).name_offset, routes.at(b).name_length) < 0;
+    });
+
+    const char* route_bytes = reinterpret_cast<const char*>(routes.data());
+    const char* order_bytes = reinterpret_cast<const char*>(name_order.data());
+    size_t route_size = routes.size() * sizeof(PackedRoute);
+    size_t order_size = name_order.size() * sizeof(uint32_t);
+    header.checksum = image_checksum(names.data(), names.size(),
+        image_checksum(order_bytes, order_size, image_checksum(route_bytes, route_size)));
+
+    string temporary = filename + ".tmp";
+    std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(route_bytes, route_size);
+    out.write(order_bytes, order_size);
+    out.write(names.data(), names.size());
+    out.write(this->data.data(), this->data.size());
+    out.close();
+    if (!out || rename(temporary.c_str(), filename.c_str()) != 0) {
+        remove(temporary.c_str());
+        claim("Unable to write the binary solution " + filename, kWarning);
+        return false;
+    }
+    return true;
+}
+
+bool Utilities::write_solution_image(string filename, const vector<Path>& paths) {
+    SolutionImageWriter writer;
+    for (unsigned i = 0; i < paths.size(); i++) {
+        writer.add(paths.at(i));
+    }
+    return writer.write(filename);
+}
+
+Utilities::SolutionImageReader::SolutionImageReader() {
+    this->data = NULL;
+    this->data_size = 0;
+    this->routes = NULL;
+    this->name_order = NULL;
+    this->names = NULL;
+    this->route_data = NULL;
+    this->next_route = 0;
+    memset(&this->header, 0, sizeof(this->header));
+}
+
+Utilities::SolutionImageReader::~SolutionImageReader() {
+    this->close();
+}
+
+/* Whether filename starts like a binary solution, without checking the rest of it */
+bool Utilities::SolutionImageReader::is_solution_image(string filename) {
+    char magic[sizeof(kSolutionMagic)];
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    return in.read(magic, sizeof(magic)) && !memcmp(magic, kSolutionMagic, sizeof(magic));
+}
+
+/*
+
+    Parameter filename (string): A binary solution written by write_solution_image
+
+    Return bool: Whether the solution was opened. The header and route index are checked
+    here, a file from another version or byte order, or whose index fails its checksum,
+    is not opened. The routes themselves are only read as they are asked for.
+
+*/
+bool Utilities::SolutionImageReader::open(string filename) {
+    this->close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SolutionHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    const char* data = static_cast<const char*>(mapped);
+
+    SolutionHeader header;
+    memcpy(&header, data, sizeof(header));
+    size_t route_size = (size_t)header.route_count * sizeof(PackedRoute);
+    size_t order_size = (size_t)header.route_count * sizeof(uint32_t);
+    bool valid = !memcmp(header.magic, kSolutionMagic, sizeof(header.magic)) &&
+        header.version == kSolutionVersion && header.byte_order == kSolutionByteOrder &&
+        header.header_size == sizeof(SolutionHeader) &&
+        size == sizeof(SolutionHeader) + route_size + order_size + header.names_size + header.data_size;
+    if (valid) {
+        valid = image_checksum(data + sizeof(SolutionHeader), route_size + order_size + header.names_size) ==
+            header.checksum;
+    }
+    const PackedRoute* routes = reinterpret_cast<const PackedRoute*>(data + sizeof(SolutionHeader));
+    const uint32_t* name_order = reinterpret_cast<const uint32_t*>(data + sizeof(SolutionHeader) + route_size);
+    for (unsigned i = 0; i < header.route_count && valid; i++) {
+        uint64_t data_end = (i + 1 < header.route_count) ? routes[i + 1].data_offset : header.data_size;
+        valid = (uint64_t)routes[i].name_offset + routes[i].name_length <= header.names_size &&
+            routes[i].data_offset <= data_end && data_end <= header.data_size &&
+            name_order[i] < header.route_count;
+    }
+    if (!valid) {
+        munmap(mapped, size);
+        claim("The binary solution " + filename + " is from another version or damaged", kWarning);
+        return false;
+    }
+    // find() binary searches the names and jumps to one route, so no read ahead
+    madvise(mapped, size, MADV_RANDOM);
+
+    this->data = data;
+    this->data_size = size;
+    this->header = header;
+    this->routes = routes;
+    this->name_order = name_order;
+    this->names = data + sizeof(SolutionHeader) + route_size + order_size;
+    this->route_data = reinterpret_cast<const uint8_t*>(this->names + header.names_size);
+    this->next_route = 0;
+    return true;
+}
+
+void Utilities::SolutionImageReader::close() {
+    if (this->data != NULL) {
+        munmap(const_cast<char*>(this->data), this->data_size);
+    }
+    this->data = NULL;
+    this->data_size = 0;
+    this->routes = NULL;
+    this->name_order = NULL;
+    this->names = NULL;
+    this->route_data = NULL;
+    this->next_route = 0;
+    memset(&this->header, 0, sizeof(this->header));
+}
+
+bool Utilities::SolutionImageReader::is_open() const {
+    return this->data != NULL;
+}
+
+unsigned Utilities::SolutionImageReader::size() const {
+    return this->header.route_count;
+}
+
+string Utilities::SolutionImageReader::get_name(unsigned index) const {
+    if (index >= this->header.route_count) {
+        claim("Attempting to read a route outside of the binary solution", kError);
+    }
+    return string(this->names + this->routes[index].name_offset, this->routes[index].name_length);
+}
+
+/*
+
+    Parameter index (unsigned): Which route, in the order they were written
+              path (Path*): Filled in with the route
+
+    Return bool: Whether the route was decoded, false if its data is damaged.
+
+*/
+bool Utilities::SolutionImageReader::read(unsigned index, Path* path) const {
+    if (index >= this->header.route_count) {
+        claim("Attempting to read a route outside of the binary solution", kError);
+    }
+    const PackedRoute& packed = this->routes[index];
+    uint64_t data_end = (index + 1 < this->header.route_count) ? this->routes[index + 1].data_offset
+                                                               : this->header.data_size;
+    const uint8_t* at = this->route_data + packed.data_offset;
+    const uint8_t* end = this->route_data + data_end;
+    *path = Path();
+    path->set_name(string(this->names + packed.name_offset, packed.name_length));
+
+    int count, form, source_x, source_y, sink_dx, sink_dy;
+    bool valid = get_varint(&at, end, &count) && get_varint(&at, end, &form) &&
+        get_varint(&at, end, &source_x) && get_varint(&at, end, &source_y) &&
+        get_varint(&at, end, &sink_dx) && get_varint(&at, end, &sink_dy) &&
+        count >= 0 && form >= kChainNone && form <= kChainBackwards;
+    Point source(source_x, source_y), sink(source_x + sink_dx, source_y + sink_dy);
+    if (valid) {
+        path->set_source(source);
+        path->set_sink(sink);
+        path->reserve(count);
+    }
+
+    if (valid && count > 0 && form != kChainNone) {
+        int start_dx, start_dy;
+        valid = get_varint(&at, end, &start_dx) && get_varint(&at, end, &start_dy);
+        Point from = (form == kChainForwards) ? source : sink;
+        Point at_point(from.x + start_dx, from.y + start_dy);
+        for (int i = 0; i < count && valid; i++) {
+            int step;
+            valid = get_varint(&at, end, &step);
+            Point next = apply_step(at_point, step);
+            if (valid) {
+                if (form == kChainForwards) {
+                    path->add_segment(at_point, next);
+                } else {
+                    path->add_segment(next, at_point);
+                }
+            }
+            at_point = next;
+        }
+    } else if (valid) {
+        Point previous = source;
+        for (int i = 0; i < count && valid; i++) {
+            int source_dx, source_dy, segment_dx, segment_dy;
+            valid = get_varint(&at, end, &source_dx) && get_varint(&at, end, &source_dy) &&
+                get_varint(&at, end, &segment_dx) && get_varint(&at, end, &segment_dy) &&
+                (segment_dx == 0 || segment_dy == 0);
+            if (valid) {
+                Point segment_source(previous.x + source_dx, previous.y + source_dy);
+                previous = Point(segment_source.x + segment_dx, segment_source.y + segment_dy);
+                path->add_segment(segment_source, previous);
+            }
+        }
+    }
+    if (!valid || at != end) {
+        claim("Route " + path->get_name() + " of the binary solution is damaged", kWarning);
+        return false;
+    }
+    return true;
+}
+
+// Orders like std::string::compare, the order the writer sorted the names in
+int Utilities::SolutionImageReader::compare_name(unsigned index, const string& name) const {
+    const PackedRoute& packed = this->routes[index];
+    int order = memcmp(this->names + packed.name_offset, name.data(), std::min((size_t)packed.name_length, name.size()));
+    if (order != 0) {
+        return order;
+    }
+    return (packed.name_length < name.size()) ? -1 : (packed.name_length > name.size()) ? 1 : 0;
+}
+
+/*
+
+    Parameter name (const string&): The connection name to look for
+              path (Path*): Filled in with the first route written under that name
+
+    Return bool: Whether a route of that name was found and decoded. A binary search of
+    the name index, only that route's data is read.
+
+*/
+bool Utilities::SolutionImageReader::find(const string& name, Path* path) const {
+    unsigned low = 0, high = this->header.route_count;
+    while (low < high) {
+        unsigned middle = low + (high - low) / 2;
+        if (this->compare_name(this->name_order[middle], name) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == this->header.route_count || this->compare_name(this->name_order[low], name) != 0) {
+        return false;
+    }
+    return this->read(this->name_order[low], path);
+}
+
+/* Decodes the route after the last one next() returned, skipping damaged ones, false once every route has been read */
+bool Utilities::SolutionImageReader::next(Path* path) {
+    while (this->next_route < this->header.route_count) {
+        if (this->read(this->next_route++, path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Utilities::SolutionImageReader::rewind() {
+    this->next_route = 0;
+}
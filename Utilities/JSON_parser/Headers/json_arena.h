@@ -0,0 +1,64 @@
+
+#ifndef _JSON_PARSER_JSON_ARENA_H_
+#define _JSON_PARSER_JSON_ARENA_H_
+
+#include <new>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include <cstddef>
+
+namespace JSON {
+	/*
+	 * Bump allocator for the nodes of one JsonFile. Allocation hands out the next bytes
+	 * of the current block and everything is freed together when the arena goes away,
+	 * so nothing is freed one node at a time. Destructors are never run, which is why
+	 * only trivially destructible types may be created in it.
+	 */
+	class JsonArena {
+		private:
+			std::vector<char*> blocks;
+			char* current;				// next free byte of the newest block
+			size_t remaining;			// bytes left in the newest block
+			size_t next_block_size;		// grows geometrically up to kMaxBlockSize
+			size_t used;				// bytes handed out, for reporting
+			size_t reserved;			// bytes of all blocks
+
+			static const size_t kFirstBlockSize = 64 * 1024;
+			static const size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+			void add_block(size_t minimum);
+
+			/* Owns its blocks, not copyable */
+			JsonArena(const JsonArena&);
+			JsonArena& operator=(const JsonArena&);
+		public:
+			/* Constructors */
+			JsonArena();
+			~JsonArena();
+
+			/* Allocation */
+			void* allocate(size_t size,size_t alignment);
+			template <typename T,typename... Args>
+			T* create(Args&&... args) {
+				static_assert(std::is_trivially_destructible<T>::value,
+						"JsonArena never runs destructors");
+				return new (allocate(sizeof(T),alignof(T))) T(std::forward<Args>(args)...);
+			}
+			// Uninitialised room for count elements, for the children of a node
+			template <typename T>
+			T* create_array(size_t count) {
+				static_assert(std::is_trivially_destructible<T>::value,
+						"JsonArena never runs destructors");
+				return static_cast<T*>(allocate(sizeof(T) * count,alignof(T)));
+			}
+			void clear();
+
+			/* Accessors */
+			size_t bytes_used() { return used; }
+			size_t bytes_reserved() { return reserved; }
+	};
+}
+
+#endif // _JSON_PARSER_JSON_ARENA_H_
@@ -4,27 +4,31 @@
 
 #include "json_value.h"
 
-#include <vector>
 #include <cstdio>
 
 namespace JSON {
 	class JsonArray {
 		private:
-			std::vector<JsonValue*> values;
+			JsonValue** values;		// in the JsonFile's arena
+			unsigned count;
 		public:
 			/* Constructors */
+			JsonArray():values(NULL),count(0) { }
 
 			/* Modifiers */
-			void push_back(JsonValue* new_value) { values.push_back(new_value); }
+			void assign(JsonValue** new_values,unsigned new_count) {
+				values = new_values;
+				count = new_count;
+			}
 
 			/* Accessors */
-			unsigned size() { return values.size(); }
-			bool empty() { return values.empty(); }
+			unsigned size() { return count; }
+			bool empty() { return count == 0; }
 			JsonValue* at(unsigned index) {
-				if (index >= values.size()) {
+				if (index >= count) {
 					return NULL;
 				}
-				return values.at(index);
+				return values[index];
 			}
 	};
 }
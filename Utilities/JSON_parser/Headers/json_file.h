@@ -5,6 +5,9 @@
 #include "json_array.h"
 #include "json_object.h"
 #include "json_name_value.h"
+#include "json_handler.h"
+#include "json_input.h"
+#include "json_arena.h"
 
 #include <stack>
 #include <vector>
@@ -22,40 +25,65 @@ namespace JSON {
 					JsonArray* array;
 					JsonNameValue* name_value;
 				} value;
-				//TODO: How to make this a friend class of JsonFile
-				//friend class JsonFile;
+				size_t first_child;		// where its children start in the JsonFile's pending lists
 				/* Constructors */
-				explicit StackItem(StackType new_type);
-				void add(JsonObject* new_object);
-				void add(JsonArray* new_array);
-				void add(JsonNameValue* new_name_value);
+				StackItem(JsonObject* object,size_t first):type(kObject),first_child(first) { value.object = object; }
+				StackItem(JsonArray* array,size_t first):type(kArray),first_child(first) { value.array = array; }
+				explicit StackItem(JsonNameValue* name_value):type(kNameValue),first_child(0) { value.name_value = name_value; }
 		};
 	}
-	class JsonFile {
-		//friend class JSON::Stack::StackItem;
+	class JsonFile : public JsonHandler {
 		private:
-			std::vector<JsonObject> objects;
-			std::vector<JsonNameValue> name_values;
-			std::vector<JsonArray> arrays;
-			/* Memory Management */
-			std::vector<JsonValue*> values;
+			std::vector<JsonObject*> objects;
+			std::vector<JsonNameValue*> name_values;
+			std::vector<JsonArray*> arrays;
+			unsigned value_count;
 
-			// Used for parsing
+			/* Memory Management, every node lives in the arena and goes with it */
+			JsonArena arena;
+
+			// Used for parsing, children wait in the pending lists until their parent closes
 			std::stack<Stack::StackItem> items;
+			std::vector<JsonNameValue*> pending_name_values;
+			std::vector<JsonValue*> pending_values;
+
+			/* Input, string values and names are views into it */
+			JsonInput input;
 
 			/* Helper functions */
-			void remove_quotes(char*& quoted);
 			void set_current_value(JSON::JsonValue* new_value);
+			void close_item(Stack::StackItem& item);
+
+			/* Owns its input, not copyable */
+			JsonFile(const JsonFile&);
+			JsonFile& operator=(const JsonFile&);
 		public:
 			/* Constructors */
-			JsonFile() { }
+			JsonFile():value_count(0) { }
 			~JsonFile();
 
+			/* Input */
+			JsonInput* get_input() { return &input; }
+			JsonArena* get_arena() { return &arena; }
+
+			/* Parser events, build the DOM */
+			void start_object() { create_object(); }
+			void end_object() { pop_stack(); }
+			void start_array() { create_array(); }
+			void end_array() { pop_stack(); }
+			void start_name_value(const JsonString& name) { create_name_value(name); }
+			void end_name_value() { pop_stack(); }
+			void string_value(const JsonString& value) { set_current_value(value); }
+			void int_value(int value) { set_current_value(value); }
+			void float_value(float value) { set_current_value(value); }
+			void bool_value(bool value) { set_current_value(value); }
+			void null_value() { set_current_value(); }
+
 			/* Modifiers */
 			void create_object();
 			void create_array();
-			void create_name_value(char* name);
-			void set_current_value(char* value);
+			void create_name_value(const JsonString& name);
+			void set_current_value(const JsonString& value);
 			void set_current_value(float value);
 			void set_current_value(int value);
 			void set_current_value(bool value);
@@ -66,17 +94,17 @@ namespace JSON {
 			unsigned objects_size() { return objects.size(); }
 			JsonObject* objects_at(unsigned index) {
 				if (index >= objects.size()) { return NULL; }
-				return &objects.at(index);
+				return objects.at(index);
 			}
 			unsigned name_values_size() { return name_values.size(); }
 			JsonNameValue* name_values_at(unsigned index) {
 				if (index >= name_values.size()) { return NULL; }
-				return &name_values.at(index);
+				return name_values.at(index);
 			}
 			JsonValue* name_values_at(const string& key) {
 				for (unsigned i = 0;i < name_values.size();i++) {
-					if (name_values.at(i).name_matches(key)) { 
-						return name_values.at(i).get_value();
+					if (name_values.at(i)->name_matches(key)) { 
+						return name_values.at(i)->get_value();
 					}
 				}
 				return NULL;
@@ -0,0 +1,37 @@
+
+#ifndef _JSON_PARSER_JSON_HANDLER_H_
+#define _JSON_PARSER_JSON_HANDLER_H_
+
+#include "json_value.h"
+
+namespace JSON {
+	/*
+	 * Receives the parser's events in document order. JsonFile builds the DOM from them,
+	 * other handlers can pick out what they need without building it. Every event has
+	 * an empty default, so handlers only override the ones they use.
+	 *
+	 * Strings are views into the JsonInput being parsed and are only valid as long as
+	 * it is, decode_string() copies one out.
+	 */
+	class JsonHandler {
+		public:
+			virtual ~JsonHandler() { }
+
+			/* Structure */
+			virtual void start_object() { }
+			virtual void end_object() { }
+			virtual void start_array() { }
+			virtual void end_array() { }
+			virtual void start_name_value(const JsonString& name) { }
+			virtual void end_name_value() { }
+
+			/* Values */
+			virtual void string_value(const JsonString& value) { }
+			virtual void int_value(int value) { }
+			virtual void float_value(float value) { }
+			virtual void bool_value(bool value) { }
+			virtual void null_value() { }
+	};
+}
+
+#endif // _JSON_PARSER_JSON_HANDLER_H_
@@ -0,0 +1,43 @@
+
+#ifndef _JSON_PARSER_JSON_INPUT_H_
+#define _JSON_PARSER_JSON_INPUT_H_
+
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+using std::string;
+
+namespace JSON {
+	/*
+	 * The text of a JSON file, mapped read-only or, when the file cannot be mapped
+	 * (empty files, pipes), read into memory. Parsed strings are views into it, so it
+	 * has to outlive them.
+	 */
+	class JsonInput {
+		private:
+			char* mapped;					// the mmap'd file, NULL when read into buffer
+			size_t mapped_size;
+			std::vector<char> buffer;		// used if the file cannot be mapped
+
+			/* Owns the mapping, not copyable */
+			JsonInput(const JsonInput&);
+			JsonInput& operator=(const JsonInput&);
+		public:
+			/* Constructors */
+			JsonInput():mapped(NULL),mapped_size(0) { }
+			~JsonInput() { release(); }
+
+			/* Modifiers */
+			bool load(const string& filename);
+			void release();
+
+			/* Accessors */
+			const char* begin() { return mapped ? mapped : (buffer.empty() ? NULL : &buffer[0]); }
+			const char* end() { return begin() + size(); }
+			size_t size() { return mapped ? mapped_size : buffer.size(); }
+	};
+}
+
+#endif // _JSON_PARSER_JSON_INPUT_H_
@@ -7,19 +7,21 @@
 namespace JSON {
 	class JsonNameValue {
 		private:
-			string name;
+			JsonString name;			// points into the JsonFile input
 			JsonValue* value;
 		public:
 			/* Constructors */
-			JsonNameValue():value(NULL) { }
-			explicit JsonNameValue(string new_name);
+			JsonNameValue();
+			explicit JsonNameValue(const JsonString& new_name);
 
 			/* Modifiers */
 			void set_value(JsonValue* new_value) { value = new_value; }
 
 			/* Accessors */
-			string get_name() { return name; }
-			bool name_matches(const string& key) { return !name.compare(key); }
+			string get_name() { return decode_string(name); }
+			const JsonString& get_raw_name() { return name; }
+			bool name_matches(const string& key) { return string_matches(name,key); }
+			bool name_matches(const JsonKey& key) { return string_matches(name,key); }
 			JsonValue* get_value() { return value; }
 	};
 }
@@ -4,27 +4,38 @@
 
 #include "json_name_value.h"
 
-#include <vector>
-
 namespace JSON {
 	class JsonValue;
 	class JsonObject{
 		private:
-			std::vector<JsonNameValue*> name_values;
+			JsonNameValue** name_values;	// in the JsonFile's arena
+			unsigned count;
+			unsigned* slots;				// open addressed index of name_values, NULL if not indexed
+			unsigned slot_mask;
 		public:
+			/* Objects with at least this many names get a hash index */
+			static const unsigned kIndexedSize = 8;
+
 			/* Constructors */
+			JsonObject():name_values(NULL),count(0),slots(NULL),slot_mask(0) { }
 
 			/* Modifiers */
-			void push_back(JsonNameValue* new_value) { name_values.push_back(new_value); }
+			void assign(JsonNameValue** new_name_values,unsigned new_count) {
+				name_values = new_name_values;
+				count = new_count;
+			}
+			static unsigned index_size(unsigned name_count);
+			void build_index(unsigned* new_slots,unsigned size);
 
 			/* Accessors */
-			JsonValue* find(string key);
-			unsigned size() { return name_values.size(); }
+			JsonValue* find(const string& key);
+			JsonValue* find(const JsonKey& key);
+			unsigned size() { return count; }
 			JsonNameValue* at(unsigned index) {
-				if (index >= name_values.size()) {
+				if (index >= count) {
 					return NULL;
 				}
-				return name_values.at(index);
+				return name_values[index];
 			}
 	};
 }
@@ -10,7 +10,38 @@
 #define _JSON_PARSER_H_
 
 #include "json_file.h"
+#include "json_handler.h"
+#include "json_input.h"
+
+#include <cstdio>
+
+namespace JSON {
+	/* 
+	 * Everything a single json_parse call needs. The parser and scanner keep no global
+	 * state, so separate calls (each with their own JsonFile) can run on separate threads.
+	 */
+	struct ParseContext {
+		string filename;
+		JsonHandler* handler;
+		const char* cursor;			// next character of the JsonFile input to scan
+		const char* end;
+		const char* line_start;		// first character of the current line, columns count from here
+		const char* token_start;	// last token, for error messages
+		const char* token_end;
+		int line;
+		int column;
+		const char* skip_begin;		// text the scanner jumps over, as if it were not there
+		const char* skip_end;
+		int first_token;			// handed out before the first scanned token, 0 if none
+		bool quiet;					// syntax errors are not printed
+	};
+}
 
 void json_parse(string filename,JSON::JsonFile* json_out);
+bool json_parse(string filename,JSON::JsonHandler* handler);
+bool json_parse(string filename,JSON::JsonHandler* handler,JSON::JsonInput* input);
+bool json_parse_skipping(string filename,JSON::JsonHandler* handler,JSON::JsonInput* input,
+	const char* skip_begin,const char* skip_end);
+bool json_parse_values(string filename,JSON::JsonHandler* handler,const char* begin,const char* end);
 
 #endif // _JSON_PARSER_H_
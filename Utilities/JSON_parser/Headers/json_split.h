@@ -0,0 +1,29 @@
+
+#ifndef _JSON_PARSER_JSON_SPLIT_H_
+#define _JSON_PARSER_JSON_SPLIT_H_
+
+#include <vector>
+
+namespace JSON {
+	/*
+	 * Pre-scan for parsing one large array of a file on several threads. It only looks
+	 * at structure: strings are stepped over the way the scanner steps over them, and
+	 * brackets, braces and commas are counted, nothing is decoded or parsed. Anything
+	 * it is not sure of makes it give up, the caller then parses the file as a whole.
+	 */
+
+	/*
+	 * Finds the value of the first member called name in the object the text starts
+	 * with and, if it is an array, splits its values into at most parts runs of about
+	 * equal size. bounds gets the start of the array's contents (just after the '['),
+	 * the commas between the runs and the closing ']', so run i lies between
+	 * bounds[i] (after the comma) and bounds[i + 1].
+	 *
+	 * Returns false if the text does not start with an object, if a member name before
+	 * it is escaped, or if the member is missing or not an array.
+	 */
+	bool split_member_array(const char* begin,const char* end,const char* name,unsigned parts,
+		std::vector<const char*>* bounds);
+}
+
+#endif // _JSON_PARSER_JSON_SPLIT_H_
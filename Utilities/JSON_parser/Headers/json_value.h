@@ -13,11 +13,47 @@ namespace JSON {
 	enum kJsonType {kString,kInt,kFloat,kBool,kObject,kArray,kNull,kNone};
 	string type_string(kJsonType type);
 
+	/*
+	 * A string token left where it is in the input owned by the JsonFile: data points
+	 * just past the opening quote and length stops before the closing one. Escapes are
+	 * only decoded when the string is asked for.
+	 */
+	struct JsonString {
+		const char* data;
+		unsigned length;
+		bool escaped;		// contains a backslash, must be decoded
+		unsigned hash;		// hash_string of the text as written, set by the scanner
+	};
+
+	// FNV-1a, cheap enough for the scanner to run over every string it reads
+	inline unsigned hash_string(const char* data,size_t length) {
+		unsigned hash = 2166136261u;
+		for (size_t i = 0;i < length;i++) {
+			hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	/*
+	 * A name to look up, hashed once up front. Readers that look up the same fields
+	 * over and over keep these around instead of passing strings.
+	 */
+	struct JsonKey {
+		string name;
+		unsigned hash;
+		explicit JsonKey(const string& key):name(key),hash(hash_string(key.data(),key.size())) { }
+	};
+
+	string decode_string(const JsonString& raw);
+	unsigned string_hash(const JsonString& raw);
+	bool string_matches(const JsonString& raw,const string& key);
+	bool string_matches(const JsonString& raw,const JsonKey& key);
+
 	class JsonValue {
 		private:
 			kJsonType type;
 			union {
-				string* string_value;
+				JsonString string_value;
 				int int_value;
 				float float_value;
 				bool bool_value;
@@ -27,14 +63,13 @@ namespace JSON {
 			} value;
 		public:
 			/* Constructors */
-			JsonValue(char* new_value): type(kString) { value.string_value = new string(new_value); }
+			JsonValue(const JsonString& new_value): type(kString) { value.string_value = new_value; }
 			JsonValue(float new_value): type(kFloat) { value.float_value = new_value; }
 			JsonValue(int new_value): type(kInt) { value.int_value = new_value; }
 			JsonValue(bool new_value): type(kBool) { value.bool_value = new_value; }
 			JsonValue(JsonObject* new_value): type(kObject) { value.object = new_value; }
 			JsonValue(JsonArray* new_value): type(kArray) { value.array = new_value; }
 			JsonValue():type(kNull) { value.null = NULL; }
-			~JsonValue();
 			JsonValue* operator=(const JsonValue& rhs) {
 				type = rhs.type;
 				value = rhs.value;
@@ -53,6 +88,7 @@ namespace JSON {
 
 			int size_of();
 			string get_string();
+			JsonString get_raw_string();
 			int get_int();
 			float get_float();
 			bool get_bool();
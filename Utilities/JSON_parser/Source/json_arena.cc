@@ -0,0 +1,51 @@
+
+#include "json_arena.h"
+
+#include <cstdlib>
+#include <cstdint>
+
+JSON::JsonArena::JsonArena():current(NULL),remaining(0),next_block_size(kFirstBlockSize),used(0),reserved(0) {
+}
+
+JSON::JsonArena::~JsonArena() {
+	clear();
+}
+
+void JSON::JsonArena::add_block(size_t minimum) {
+	size_t size = next_block_size;
+	while (size < minimum) { size *= 2; }
+	char* block = static_cast<char*>(malloc(size));
+	if (!block) { throw std::bad_alloc(); }
+	blocks.push_back(block);
+	current = block;
+	remaining = size;
+	reserved += size;
+	if (next_block_size < kMaxBlockSize) { next_block_size *= 2; }
+}
+
+void* JSON::JsonArena::allocate(size_t size,size_t alignment) {
+	size_t padding = (alignment - (reinterpret_cast<uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+	if (current == NULL || padding + size > remaining) {
+		// malloc'd blocks are aligned for any fundamental type
+		add_block(size);
+		padding = 0;
+	}
+	void* allocated = current + padding;
+	current += padding + size;
+	remaining -= padding + size;
+	used += size;
+	return allocated;
+}
+
+// Frees every block at once, everything created in the arena is gone afterwards
+void JSON::JsonArena::clear() {
+	for (unsigned i = 0;i < blocks.size();i++) {
+		free(blocks.at(i));
+	}
+	blocks.clear();
+	current = NULL;
+	remaining = 0;
+	next_block_size = kFirstBlockSize;
+	used = 0;
+	reserved = 0;
+}
@@ -2,6 +2,9 @@
 
 #include "json_file.h"
 
+#include <algorithm>
+#include <utility>
+
 #include <cstdio>
 
 string JSON::Stack::type_string(StackType type) {
@@ -17,154 +20,51 @@ string JSON::Stack::type_string(StackType type) {
 	}
 }
 
-void JSON::Stack::StackItem::add(JsonObject* new_object) {
-	JsonValue* new_value = new JsonValue(new_object);
-	switch(type) {
-		case kNameValue:
-			value.name_value->set_value(new_value);
-			break;
-		case kArray:
-			value.array->push_back(new_value);
-			break;
-		default:
-			//Error.
-			return;
-	}
-}
-
-void JSON::Stack::StackItem::add(JsonArray* new_array) {
-	JsonValue* new_value = new JsonValue(new_array);
-	switch(type) {
-		case kArray:
-			value.array->push_back(new_value);
-			break;
-		case kNameValue:
-			value.name_value->set_value(new_value);
-			break;
-		default:
-			//Error.
-			return;
-	}
-}
-
-void JSON::Stack::StackItem::add(JsonNameValue* new_name_value) {
-	JsonValue* new_value = new JsonValue(new_name_value);
-	switch (type) {
-		case kArray:
-			value.array->push_back(new_value);
-			break;
-		case kNameValue:
-			value.name_value->set_value(new_value);
-			break;
-		case kObject:
-			value.object->push_back(new_name_value);
-			break;
-		default:
-			return;
-	}
-}
-
-JSON::Stack::StackItem::StackItem(StackType new_type):type(new_type) {
-	switch(new_type) {
-		case kObject:
-			value.object = new JsonObject();
-			break;
-		case kArray:
-			value.array = new JsonArray();
-			break;
-		case kNameValue:
-			value.name_value = new JsonNameValue();
-			break;
-	}
-}
-
 JSON::JsonFile::~JsonFile() {
-	int values_deleted = 0;
-	int values_size_deleted = 0;
-	for (unsigned i = 0;i < values.size();i++) {
-		values_deleted++;
-		values_size_deleted+=sizeof(values.at(i));
-		delete(values.at(i));
-	}
-	int stack_deleted = 0;
-	int stack_size_deleted = 0;
-	while (!items.empty()) {
-		Stack::StackItem current = items.top();
-		items.pop();
-		stack_deleted++;
-		stack_size_deleted+=sizeof(&current);
-	}
-	/*fprintf(stderr,"Deleted (%d):\n\tValues: %d(%d)\n\tStack: %d(%d)\n",
-			values_size_deleted+stack_size_deleted,
-			values_deleted,values_size_deleted,
-			stack_deleted,stack_size_deleted);*/
+	/* Every node is in the arena, which frees its blocks in one go */
 }
 
 void JSON::JsonFile::create_array() {
-	Stack::StackItem new_item(Stack::kArray);
-	items.push(new_item);
+	items.emplace(arena.create<JsonArray>(),pending_values.size());
 }
 
 void JSON::JsonFile::create_object() {
-	Stack::StackItem new_item(Stack::kObject);
-	items.push(new_item);
-}
-
-void JSON::JsonFile::create_name_value(char* name) {
-	remove_quotes(name);
-	JsonNameValue* new_name_value = new JsonNameValue(name);
-	//name_values.push_back(new_name_value);
-	Stack::StackItem new_item(Stack::kNameValue);
-	new_item.value.name_value = new_name_value;
-	items.push(new_item);
+	items.emplace(arena.create<JsonObject>(),pending_name_values.size());
 }
 
-void JSON::JsonFile::remove_quotes(char*& quoted) {
-	if (*quoted == '\"') { quoted+=1; }
-	char* find_quote = quoted;
-	while (*find_quote != '\"' && *find_quote != '\0') { find_quote++; }
-	*find_quote = '\0';
+void JSON::JsonFile::create_name_value(const JsonString& name) {
+	items.emplace(arena.create<JsonNameValue>(name));
 }
 
-void JSON::JsonFile::set_current_value(char* value) {
-	remove_quotes(value);
-	JSON::JsonValue* new_value = new JSON::JsonValue(value);
-	values.push_back(new_value);
-	set_current_value(new_value);
+void JSON::JsonFile::set_current_value(const JsonString& value) {
+	set_current_value(arena.create<JsonValue>(value));
 }
 
 void JSON::JsonFile::set_current_value(float value) {
-	JSON::JsonValue* new_value = new JSON::JsonValue(value);
-	values.push_back(new_value);
-	set_current_value(new_value);
+	set_current_value(arena.create<JsonValue>(value));
 }
 
 void JSON::JsonFile::set_current_value(int value) {
-	JSON::JsonValue* new_value = new JSON::JsonValue(value);
-	values.push_back(new_value);
-	set_current_value(new_value);
+	set_current_value(arena.create<JsonValue>(value));
 }
 
 void JSON::JsonFile::set_current_value() {
-	JSON::JsonValue* new_value = new JSON::JsonValue();
-	values.push_back(new_value);
-	set_current_value(new_value);
+	set_current_value(arena.create<JsonValue>());
 }
 	
 void JSON::JsonFile::set_current_value(bool value) {
-	JSON::JsonValue* new_value = new JSON::JsonValue(value);
-	values.push_back(new_value);
-	set_current_value(new_value);
+	set_current_value(arena.create<JsonValue>(value));
 }
 
 void JSON::JsonFile::set_current_value(JSON::JsonValue* new_value) {
+	value_count++;
 	if (items.empty()) {
 		return;
 	}
-	Stack::StackItem top_item = items.top();
+	Stack::StackItem& top_item = items.top();
 	switch (top_item.type) {
 		case Stack::kArray:
-			top_item.value.array->push_back(new_value);
+			pending_values.push_back(new_value);
 			break;
 		case Stack::kNameValue:
 			top_item.value.name_value->set_value(new_value);
@@ -175,36 +75,70 @@ void JSON::JsonFile::set_current_value(JSON::JsonValue* new_value) {
 	}
 }
 
+/*
+ * Moves the children an object or array collected in the pending lists into a single
+ * array in the arena, sized to fit now that all of them are known.
+ */
+void JSON::JsonFile::close_item(Stack::StackItem& item) {
+	switch (item.type) {
+		case Stack::kObject: {
+			unsigned count = pending_name_values.size() - item.first_child;
+			JsonNameValue** children = arena.create_array<JsonNameValue*>(count);
+			std::copy(pending_name_values.begin() + item.first_child,pending_name_values.end(),children);
+			pending_name_values.resize(item.first_child);
+			item.value.object->assign(children,count);
+			if (count >= JsonObject::kIndexedSize) {
+				unsigned size = JsonObject::index_size(count);
+				item.value.object->build_index(arena.create_array<unsigned>(size),size);
+			}
+			break;
+		}
+		case Stack::kArray: {
+			unsigned count = pending_values.size() - item.first_child;
+			JsonValue** children = arena.create_array<JsonValue*>(count);
+			std::copy(pending_values.begin() + item.first_child,pending_values.end(),children);
+			pending_values.resize(item.first_child);
+			item.value.array->assign(children,count);
+			break;
+		}
+		default:
+			return;
+	}
+}
+
 void JSON::JsonFile::pop_stack() {
 	if (items.empty()) {
 		return;
 	}
-	Stack::StackItem popped = items.top();
+	Stack::StackItem popped = std::move(items.top());
 	items.pop();
+	close_item(popped);
 	if (items.empty()) { 
 		switch (popped.type) {
 			case Stack::kObject:
-				objects.push_back(*(popped.value.object));
+				objects.push_back(popped.value.object);
 				break;
 			case Stack::kNameValue:
-				name_values.push_back(*(popped.value.name_value));
+				name_values.push_back(popped.value.name_value);
 				break;
 			default:
 				return;
 		}
 		return; 
 	}
-	Stack::StackItem top_item = items.top();
+	Stack::StackItem& top_item = items.top();
 	switch (popped.type) {
 		case Stack::kObject:
-			top_item.add(popped.value.object);
+			set_current_value(arena.create<JsonValue>(popped.value.object));
 			break;
 		case Stack::kArray:
-			arrays.push_back(*(popped.value.array));
-			top_item.add(popped.value.array);
+			arrays.push_back(popped.value.array);
+			set_current_value(arena.create<JsonValue>(popped.value.array));
 			break;
 		case Stack::kNameValue:
-			top_item.add(popped.value.name_value);
+			if (top_item.type == Stack::kObject) {
+				pending_name_values.push_back(popped.value.name_value);
+			}
 			break;
 		default:
 			return;
@@ -215,12 +149,12 @@ void JSON::JsonFile::print() {
 	fprintf(stderr,"%d objects loaded.\n",objects.size());
 	fprintf(stderr,"%d Name Values loaded.\n",name_values.size());
 	for (unsigned i = 0;i < name_values.size();i++) {
-		fprintf(stderr,"\t%s",name_values.at(i).get_name().c_str());
-		fprintf(stderr,": %s",name_values.at(i).get_value()->type_string().c_str());
-		if (name_values.at(i).get_value()->is_array()) {
-			fprintf(stderr," (%d)\n",name_values.at(i).get_value()->get_array()->size());
-			for (unsigned j = 0;j < name_values.at(i).get_value()->get_array()->size();j++) {
-				fprintf(stderr,"\t\t%s\n",name_values.at(i).get_value()->get_array()->at(j)->type_string().c_str());
+		fprintf(stderr,"\t%s",name_values.at(i)->get_name().c_str());
+		fprintf(stderr,": %s",name_values.at(i)->get_value()->type_string().c_str());
+		if (name_values.at(i)->get_value()->is_array()) {
+			fprintf(stderr," (%d)\n",name_values.at(i)->get_value()->get_array()->size());
+			for (unsigned j = 0;j < name_values.at(i)->get_value()->get_array()->size();j++) {
+				fprintf(stderr,"\t\t%s\n",name_values.at(i)->get_value()->get_array()->at(j)->type_string().c_str());
 			}
 		} else {
 			fprintf(stderr,"\n");
@@ -230,10 +164,8 @@ void JSON::JsonFile::print() {
 }
 
 void JSON::JsonFile::print_values() {
-	fprintf(stderr,"%d values loaded.\n",values.size());
-	for (unsigned i = 0;i < values.size();i++) {
-		//fprintf(stderr,"%d: \"%s\"\n",i,values.at(i)->type_string().c_str());
-	}
+	fprintf(stderr,"%d values loaded.\n",value_count);
+	fprintf(stderr,"%d bytes in the arena (%d reserved).\n",(int)arena.bytes_used(),(int)arena.bytes_reserved());
 }
 
 void JSON::JsonFile::print_stack() {
@@ -0,0 +1,43 @@
+
+#include "json_input.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Maps filename read-only, falling back to reading it into memory when it cannot be
+ * mapped. Returns false if the file could not be opened or read.
+ */
+bool JSON::JsonInput::load(const string& filename) {
+	release();
+	int fd = open(filename.c_str(),O_RDONLY);
+	if (fd < 0) { return false; }
+	struct stat info;
+	if (fstat(fd,&info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+		void* data = mmap(NULL,info.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if (data != MAP_FAILED) {
+			mapped = static_cast<char*>(data);
+			mapped_size = info.st_size;
+			close(fd);
+			return true;
+		}
+	}
+	char chunk[65536];
+	ssize_t read_size;
+	while ((read_size = read(fd,chunk,sizeof(chunk))) > 0) {
+		buffer.insert(buffer.end(),chunk,chunk + read_size);
+	}
+	close(fd);
+	return read_size == 0;
+}
+
+void JSON::JsonInput::release() {
+	if (mapped) {
+		munmap(mapped,mapped_size);
+		mapped = NULL;
+		mapped_size = 0;
+	}
+	std::vector<char>().swap(buffer);
+}
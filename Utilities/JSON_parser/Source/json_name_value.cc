@@ -1,6 +1,12 @@
 
 #include "json_name_value.h"
 
-JSON::JsonNameValue::JsonNameValue(string new_name) {
-	name = new_name;
+JSON::JsonNameValue::JsonNameValue():value(NULL) {
+	name.data = "";
+	name.length = 0;
+	name.escaped = false;
+	name.hash = hash_string("",0);
+}
+
+JSON::JsonNameValue::JsonNameValue(const JsonString& new_name):name(new_name),value(NULL) {
 }
@@ -1,14 +1,58 @@
 
-
 #include "json_object.h"
 
 #include <cstdio>
 
-JSON::JsonValue* JSON::JsonObject::find(string key) {
-	for (unsigned i = 0;i < name_values.size();i++) {
-		if (name_values.at(i)->name_matches(key)) {
-			return name_values.at(i)->get_value();
+JSON::JsonValue* JSON::JsonObject::find(const string& key) {
+	return find(JsonKey(key));
+}
+
+/*
+ * The first name-value called key, like a linear search would give. Hashes are
+ * compared first, so names are only compared when the hash already matches.
+ */
+JSON::JsonValue* JSON::JsonObject::find(const JsonKey& key) {
+	if (slots) {
+		for (unsigned slot = key.hash & slot_mask;slots[slot];slot = (slot + 1) & slot_mask) {
+			if (name_values[slots[slot] - 1]->name_matches(key)) {
+				return name_values[slots[slot] - 1]->get_value();
+			}
+		}
+		return NULL;
+	}
+	for (unsigned i = 0;i < count;i++) {
+		if (name_values[i]->name_matches(key)) {
+			return name_values[i]->get_value();
 		}
 	}
 	return NULL;
 }
+
+// Slots for an index of name_count names, a power of two at most half full
+unsigned JSON::JsonObject::index_size(unsigned name_count) {
+	unsigned size = 16;
+	while (size < 2 * name_count) { size *= 2; }
+	return size;
+}
+
+/*
+ * Indexes the name-values into new_slots (size from index_size()). Each slot holds a
+ * position + 1, or 0 when empty. Repeated names are left out so the first one wins.
+ */
+void JSON::JsonObject::build_index(unsigned* new_slots,unsigned size) {
+	slots = new_slots;
+	slot_mask = size - 1;
+	for (unsigned i = 0;i < size;i++) { slots[i] = 0; }
+	for (unsigned i = 0;i < count;i++) {
+		JsonKey key(name_values[i]->get_name());
+		unsigned slot = key.hash & slot_mask;
+		bool repeated = false;
+		for (;slots[slot];slot = (slot + 1) & slot_mask) {
+			if (name_values[slots[slot] - 1]->name_matches(key)) {
+				repeated = true;
+				break;
+			}
+		}
+		if (!repeated) { slots[slot] = i + 1; }
+	}
+}
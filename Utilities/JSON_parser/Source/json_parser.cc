@@ -10,24 +10,75 @@
 #include "json_parser.h"
 #include "json_parser_bison.hh"
 
-int jsonparse();
-extern FILE* jsonin;
-int jsonrestart(FILE*);
-void clean_flex();
-string fn;
-
-JSON::JsonFile* json_file;
+// Sets up context to scan the text from begin to end, starting on line 1
+static void start_context(JSON::ParseContext* context,string filename,JSON::JsonHandler* handler,
+		const char* begin,const char* end){
+	context->filename = filename;
+	context->handler = handler;
+	context->cursor = begin;
+	context->end = end;
+	context->line_start = begin;
+	context->token_start = begin;
+	context->token_end = begin;
+	context->line = 1;
+	context->column = 0;
+	context->skip_begin = NULL;
+	context->skip_end = NULL;
+	context->first_token = 0;
+	context->quiet = false;
+}
 
+// Builds the DOM, the JsonFile keeps the input its strings point into
 void json_parse(string filename,JSON::JsonFile* json_out){
-	fn = filename;
-	json_file = json_out;
-	jsonin = fopen(filename.c_str(),"r");
-	if(!jsonin){
+	json_parse(filename,json_out,json_out->get_input());
+}
+
+// Streams events to handler, the input is released when parsing is done
+bool json_parse(string filename,JSON::JsonHandler* handler){
+	JSON::JsonInput input;
+	return json_parse(filename,handler,&input);
+}
+
+/*
+ * Loads filename into input and sends the parse events to handler. Returns false if the
+ * file could not be read or did not parse.
+ */
+bool json_parse(string filename,JSON::JsonHandler* handler,JSON::JsonInput* input){
+	if(!input->load(filename)){
 		fprintf(stderr,"Error: json: Unable to open \"%s\".\n",filename.c_str());
-		return;
+		return false;
 	}
-	jsonrestart(jsonin);
-	jsonparse();
-	fclose(jsonin);
-	clean_flex();
+	//The scanner works directly on the mapped file
+	JSON::ParseContext context;
+	start_context(&context,filename,handler,input->begin(),input->end());
+	return jsonparse(&context) == 0;
+}
+
+/*
+ * Parses an input that is already loaded, leaving out the text from skip_begin to
+ * skip_end, which has to start and end between two tokens. Used to parse a file while
+ * one of its arrays is parsed elsewhere with json_parse_values. Syntax errors are not
+ * printed, line numbers after the skipped text would not be right.
+ */
+bool json_parse_skipping(string filename,JSON::JsonHandler* handler,JSON::JsonInput* input,
+		const char* skip_begin,const char* skip_end){
+	JSON::ParseContext context;
+	start_context(&context,filename,handler,input->begin(),input->end());
+	context.skip_begin = skip_begin;
+	context.skip_end = skip_end;
+	context.quiet = true;
+	return jsonparse(&context) == 0;
+}
+
+/*
+ * Parses the text from begin to end as one or more comma separated values, such as
+ * a run of the values of an array, and sends their events to handler. Returns false
+ * if it is anything else. Syntax errors are not printed, the text is not a file.
+ */
+bool json_parse_values(string filename,JSON::JsonHandler* handler,const char* begin,const char* end){
+	JSON::ParseContext context;
+	start_context(&context,filename,handler,begin,end);
+	context.first_token = VALUES;
+	context.quiet = true;
+	return jsonparse(&context) == 0;
 }
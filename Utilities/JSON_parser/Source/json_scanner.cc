@@ -0,0 +1,182 @@
+/* File: json_scanner.cc
+ * Description: Reentrant scanner for the JSON parser, replaces the flex scanner
+ * (json_parser.lex). Accepts the same tokens: all scanner state is kept in the
+ * ParseContext handed to jsonlex by the pure bison parser.
+ *
+ * The scanner walks the input owned by the JsonFile (usually the mapped file) with a
+ * single pointer. The input is not NUL terminated, so every read is checked against
+ * the end. Line and column are kept up to date in the token actions: lines are counted
+ * as newlines are passed and the column is the distance from the start of the current
+ * line, so no character is looked at more than once.
+ */
+
+#include "json_parser.h"
+#include "json_parser_bison.hh"
+
+#include <cstdlib>
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+static inline bool is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+static inline char to_lower(char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+static inline const char* skip_digits(const char* c,const char* end) {
+	while (c < end && is_digit(*c)) { c++; }
+	return c;
+}
+
+static inline int finish_token(JSON::ParseContext* context,const char* token_start,int token) {
+	context->token_start = token_start;
+	context->token_end = context->cursor;
+	context->column = context->cursor - context->line_start;
+	return token;
+}
+
+/*
+ * Numbers: -?{DIGIT}+ is an INTNUM, with a fraction (and optional exponent) it is a
+ * NUMBER. Anything the flex scanner would have skipped (a lone '-', a '.' or 'e'
+ * without digits) is skipped here as well.
+ */
+static int scan_number(YYSTYPE* jsonlval,JSON::ParseContext* context) {
+	const char* start = context->cursor;
+	const char* end = context->end;
+	const char* c = start;
+	bool negative = (*c == '-');
+	if (negative) {
+		c++;
+		if (c == end || !is_digit(*c)) {
+			context->cursor = c;
+			return -1;
+		}
+	}
+	int value = 0;
+	while (c < end && is_digit(*c)) { value = value * 10 + (*c++ - '0'); }
+	if (c == end || *c != '.' || c + 1 == end || !is_digit(c[1])) {
+		context->cursor = (c < end && *c == '.') ? c + 1 : c;
+		jsonlval->int_val = negative ? -value : value;
+		return finish_token(context,start,INTNUM);
+	}
+	c = skip_digits(c + 1,end);
+	if (c < end && (*c == 'e' || *c == 'E')) {
+		const char* exponent = c + 1;
+		if (exponent < end && (*exponent == '+' || *exponent == '-')) { exponent++; }
+		if (exponent < end && is_digit(*exponent)) { c = skip_digits(exponent,end); }
+	}
+	// strtod needs a terminated copy, the mapped input may end right after the number
+	char number[64];
+	int length = (c - start < (int)sizeof(number)) ? c - start : sizeof(number) - 1;
+	for (int i = 0;i < length;i++) { number[i] = start[i]; }
+	number[length] = '\0';
+	jsonlval->float_val = strtod(number,NULL);
+	context->cursor = c;
+	return finish_token(context,start,NUMBER);
+}
+
+/*
+ * Strings are handed to the parser as views into the input, without their quotes,
+ * and hashed on the way past. Escapes are only noted here and decoded when the value
+ * is read. Newlines inside a string still count as lines.
+ */
+static int scan_string(YYSTYPE* jsonlval,JSON::ParseContext* context) {
+	const char* start = context->cursor;
+	const char* c = start + 1;
+	const char* end = context->end;
+	bool escaped = false;
+	unsigned hash = 2166136261u;		// hash_string, folded into the scan
+	while (c < end) {
+		char current = *c++;
+		if (current == '"') {
+			context->cursor = c;
+			jsonlval->str_val.data = start + 1;
+			jsonlval->str_val.length = c - start - 2;
+			jsonlval->str_val.escaped = escaped;
+			jsonlval->str_val.hash = hash;
+			return finish_token(context,start,IDENT);
+		}
+		hash = (hash ^ (unsigned char)current) * 16777619u;
+		if (current == '\\') {
+			escaped = true;
+			if (c < end && *c == '\n') {
+				context->line++;
+				context->line_start = c + 1;
+			}
+			if (c < end) { hash = (hash ^ (unsigned char)*c++) * 16777619u; }
+		} else if (current == '\n') {
+			context->line++;
+			context->line_start = c;
+		}
+	}
+	context->cursor = end;
+	finish_token(context,start,0);
+	jsonerror(context,"unterminated string");
+	return 0;
+}
+
+// true, false and null are matched case-insensitively, other words are skipped
+static int scan_word(YYSTYPE* jsonlval,JSON::ParseContext* context) {
+	const char* start = context->cursor;
+	const char* c = start;
+	while (c < context->end && is_alpha(*c)) { c++; }
+	context->cursor = c;
+	int length = c - start;
+	if (length == 4 && to_lower(start[0]) == 't' && to_lower(start[1]) == 'r' &&
+			to_lower(start[2]) == 'u' && to_lower(start[3]) == 'e') {
+		jsonlval->bool_val = true;
+		return finish_token(context,start,TRUE);
+	}
+	if (length == 5 && to_lower(start[0]) == 'f' && to_lower(start[1]) == 'a' &&
+			to_lower(start[2]) == 'l' && to_lower(start[3]) == 's' && to_lower(start[4]) == 'e') {
+		jsonlval->bool_val = false;
+		return finish_token(context,start,FALSE);
+	}
+	if (length == 4 && to_lower(start[0]) == 'n' && to_lower(start[1]) == 'u' &&
+			to_lower(start[2]) == 'l' && to_lower(start[3]) == 'l') {
+		return finish_token(context,start,JSONNULL);
+	}
+	return -1;
+}
+
+int jsonlex(YYSTYPE* jsonlval,JSON::ParseContext* context) {
+	if (context->first_token) {
+		int token = context->first_token;
+		context->first_token = 0;
+		return token;
+	}
+	if (context->cursor == context->skip_begin) { context->cursor = context->skip_end; }
+	const char* end = context->end;
+	while (context->cursor < end) {
+		char c = *context->cursor;
+		int token = -1;
+		switch (c) {
+			case '\n':
+				context->cursor++;
+				context->line++;
+				context->line_start = context->cursor;
+				continue;
+			case ' ':
+			case '\t':
+			case '\r':
+				context->cursor++;
+				continue;
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+			case ',':
+			case ':':
+				context->cursor++;
+				return finish_token(context,context->cursor - 1,c);
+			case '"':
+				return scan_string(jsonlval,context);
+			default:
+				if (c == '-' || is_digit(c)) {
+					token = scan_number(jsonlval,context);
+				} else if (is_alpha(c)) {
+					token = scan_word(jsonlval,context);
+				} else {
+					context->cursor++;		/* anything else is skipped */
+				}
+		}
+		if (token != -1) { return token; }
+	}
+	return finish_token(context,context->cursor,0);
+}
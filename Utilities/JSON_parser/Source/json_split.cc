@@ -0,0 +1,115 @@
+/* File: json_split.cc
+ * Description: Pre-scan that finds an array of a file and splits it into runs of
+ * whole values, so the runs can be parsed on separate threads.
+ */
+
+#include "json_split.h"
+
+#include <cstring>
+
+static inline const char* skip_space(const char* c,const char* end) {
+	while (c < end && (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n')) { c++; }
+	return c;
+}
+
+// Steps over the string whose quote c is at, the same way scan_string does
+static inline const char* skip_string(const char* c,const char* end) {
+	for (c++;c < end;c++) {
+		if (*c == '"') { return c + 1; }
+		if (*c == '\\' && ++c == end) { break; }
+	}
+	return end;
+}
+
+// Steps over a value, returns the ',' or closing brace after it, or end if there is none
+static const char* skip_value(const char* c,const char* end) {
+	int depth = 0;
+	while (c < end) {
+		switch (*c) {
+			case '"':
+				c = skip_string(c,end);
+				continue;
+			case '{':
+			case '[':
+				depth++;
+				break;
+			case '}':
+			case ']':
+				if (depth == 0) { return c; }
+				depth--;
+				break;
+			case ',':
+				if (depth == 0) { return c; }
+				break;
+		}
+		c++;
+	}
+	return end;
+}
+
+/*
+ * Walks the contents of an array from c, recording a comma between values every
+ * time the current run has grown past its share of the text, and the closing ']'.
+ */
+static bool split_array(const char* c,const char* end,unsigned parts,std::vector<const char*>* bounds) {
+	size_t share = (end - c) / parts;
+	const char* run_start = c;
+	int depth = 0;
+	bounds->push_back(c);
+	while (c < end) {
+		switch (*c) {
+			case '"':
+				c = skip_string(c,end);
+				continue;
+			case '{':
+			case '[':
+				depth++;
+				break;
+			case '}':
+			case ']':
+				if (depth == 0) {
+					if (*c != ']') { return false; }
+					bounds->push_back(c);
+					return true;
+				}
+				depth--;
+				break;
+			case ',':
+				if (depth == 0 && (size_t)(c - run_start) >= share && bounds->size() < parts) {
+					bounds->push_back(c);
+					run_start = c;
+				}
+				break;
+		}
+		c++;
+	}
+	return false;
+}
+
+bool JSON::split_member_array(const char* begin,const char* end,const char* name,unsigned parts,
+		std::vector<const char*>* bounds) {
+	bounds->clear();
+	size_t name_length = strlen(name);
+	const char* c = skip_space(begin,end);
+	if (c == end || *c != '{' || parts == 0) { return false; }
+	c = skip_space(c + 1,end);
+	// Members are only read while they are plainly "name": value, separated by commas
+	while (c < end && *c == '"') {
+		const char* key = c + 1;
+		c = skip_string(c,end);
+		if (c == end) { return false; }
+		size_t key_length = c - 1 - key;
+		if (memchr(key,'\\',key_length) != NULL) { return false; }
+		c = skip_space(c,end);
+		if (c == end || *c != ':') { return false; }
+		c = skip_space(c + 1,end);
+		if (key_length == name_length && memcmp(key,name,name_length) == 0) {
+			if (c == end || *c != '[') { return false; }
+			return split_array(c + 1,end,parts,bounds);
+		}
+		c = skip_value(c,end);
+		if (c == end || *c != ',') { return false; }
+		c = skip_space(c + 1,end);
+	}
+	return false;
+}
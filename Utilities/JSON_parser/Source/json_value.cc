@@ -22,20 +22,104 @@ string JSON::type_string(kJsonType type) {
 	}
 }
 
-JSON::JsonValue::~JsonValue() {
-	if (is_string()) { 
-		delete(value.string_value);
-	} else if (is_object()) {
-		//delete(value.object);
-	} else if (is_array()) {
-		//delete(value.array);
+// Appends code point as UTF-8
+static void append_utf8(string& out,unsigned code_point) {
+	if (code_point < 0x80) {
+		out += (char)code_point;
+	} else if (code_point < 0x800) {
+		out += (char)(0xC0 | (code_point >> 6));
+		out += (char)(0x80 | (code_point & 0x3F));
+	} else if (code_point < 0x10000) {
+		out += (char)(0xE0 | (code_point >> 12));
+		out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+		out += (char)(0x80 | (code_point & 0x3F));
+	} else {
+		out += (char)(0xF0 | (code_point >> 18));
+		out += (char)(0x80 | ((code_point >> 12) & 0x3F));
+		out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+		out += (char)(0x80 | (code_point & 0x3F));
 	}
 }
 
+// Reads the four hex digits of a \u escape, returns false if they are not there
+static bool read_hex4(const char* data,unsigned length,unsigned index,unsigned& code_point) {
+	if (index + 4 > length) { return false; }
+	code_point = 0;
+	for (unsigned i = index;i < index + 4;i++) {
+		char c = data[i];
+		code_point <<= 4;
+		if (c >= '0' && c <= '9') { code_point |= c - '0'; }
+		else if (c >= 'a' && c <= 'f') { code_point |= c - 'a' + 10; }
+		else if (c >= 'A' && c <= 'F') { code_point |= c - 'A' + 10; }
+		else { return false; }
+	}
+	return true;
+}
+
+string JSON::decode_string(const JsonString& raw) {
+	if (!raw.escaped) { return string(raw.data,raw.length); }
+	string decoded;
+	decoded.reserve(raw.length);
+	for (unsigned i = 0;i < raw.length;i++) {
+		char c = raw.data[i];
+		if (c != '\\' || i + 1 == raw.length) {
+			decoded += c;
+			continue;
+		}
+		c = raw.data[++i];
+		switch (c) {
+			case 'b': decoded += '\b'; break;
+			case 'f': decoded += '\f'; break;
+			case 'n': decoded += '\n'; break;
+			case 'r': decoded += '\r'; break;
+			case 't': decoded += '\t'; break;
+			case 'u': {
+				unsigned code_point;
+				if (!read_hex4(raw.data,raw.length,i + 1,code_point)) {
+					decoded += c;		// not a valid escape, keep it as written
+					break;
+				}
+				i += 4;
+				unsigned low;
+				if (code_point >= 0xD800 && code_point < 0xDC00 && i + 2 < raw.length &&
+						raw.data[i + 1] == '\\' && raw.data[i + 2] == 'u' &&
+						read_hex4(raw.data,raw.length,i + 3,low) && low >= 0xDC00 && low < 0xE000) {
+					code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+					i += 6;
+				}
+				append_utf8(decoded,code_point);
+				break;
+			}
+			default:			// \" \\ \/ and anything unknown stand for themselves
+				decoded += c;
+		}
+	}
+	return decoded;
+}
+
+// Hash of the decoded text, comparable with JsonKey::hash
+unsigned JSON::string_hash(const JsonString& raw) {
+	if (!raw.escaped) { return raw.hash; }
+	string decoded = decode_string(raw);
+	return hash_string(decoded.data(),decoded.size());
+}
+
+bool JSON::string_matches(const JsonString& raw,const string& key) {
+	if (raw.escaped) { return decode_string(raw) == key; }
+	return raw.length == key.size() && !key.compare(0,key.size(),raw.data,raw.length);
+}
+
+// Only strings whose hash matches are compared
+bool JSON::string_matches(const JsonString& raw,const JsonKey& key) {
+	if (raw.escaped) { return decode_string(raw) == key.name; }
+	return raw.hash == key.hash && raw.length == key.name.size() &&
+		!key.name.compare(0,key.name.size(),raw.data,raw.length);
+}
+
 int JSON::JsonValue::size_of() {
 	switch (type) {
 		case kString:
-			return sizeof(value.string_value);
+			return sizeof(value.string_value) + value.string_value.length;
 		case kInt:
 			return sizeof(int);
 		case kFloat:
@@ -50,10 +134,17 @@ int JSON::JsonValue::size_of() {
 }
 
 string JSON::JsonValue::get_string() { 
-	if (is_string()) { return *value.string_value; } 
+	if (is_string()) { return decode_string(value.string_value); } 
 	return "";
 }
 
+// The undecoded string in the input buffer, only valid while the JsonFile is alive
+JSON::JsonString JSON::JsonValue::get_raw_string() {
+	if (is_string()) { return value.string_value; }
+	JsonString empty = {"",0,false,hash_string("",0)};
+	return empty;
+}
+
 int JSON::JsonValue::get_int() {
 	if (is_int()) { return value.int_value; }
 	return 0;
@@ -1,23 +1,22 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* A Bison parser, made by GNU Bison 2.4.1.  */
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
-   
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
    the Free Software Foundation, either version 3 of the License, or
    (at your option) any later version.
-   
+
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
    GNU General Public License for more details.
-   
+
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -28,59 +27,81 @@
    special exception, which will cause the skeleton and the resulting
    Bison output files to be licensed under the GNU General Public
    License without this special exception.
-   
+
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* "%code requires" blocks.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
-/* Line 1676 of yacc.c  */
-#line 24 "Source/json_parser.ypp"
-#include "json_file.h"
+#ifndef YY_JSON_JSON_PARSER_BISON_HH_INCLUDED
+# define YY_JSON_JSON_PARSER_BISON_HH_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int jsondebug;
+#endif
+/* "%code requires" blocks.  */
+#line 17 "Source/json_parser.ypp"
 
+#include "json_handler.h"
+namespace JSON { struct ParseContext; }
 
-/* Line 1676 of yacc.c  */
-#line 44 "json_parser_bison.hh"
+#line 54 "json_parser_bison.hh"
 
-/* Tokens.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     TRUE = 258,
-     FALSE = 259,
-     JSONNULL = 260,
-     NUMBER = 261,
-     INTNUM = 262,
-     IDENT = 263
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    TRUE = 258,                    /* TRUE  */
+    FALSE = 259,                   /* FALSE  */
+    JSONNULL = 260,                /* JSONNULL  */
+    NUMBER = 261,                  /* NUMBER  */
+    INTNUM = 262,                  /* INTNUM  */
+    IDENT = 263,                   /* IDENT  */
+    VALUES = 264                   /* VALUES  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
-
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
+union YYSTYPE
 {
-
-/* Line 1676 of yacc.c  */
-#line 26 "Source/json_parser.ypp"
+#line 32 "Source/json_parser.ypp"
 
 	int int_val;
 	float float_val;
-	char* str_val;
+	JSON::JsonString str_val;
 	bool bool_val;
 
+#line 87 "json_parser_bison.hh"
 
-
-/* Line 1676 of yacc.c  */
-#line 78 "json_parser_bison.hh"
-} YYSTYPE;
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE jsonlval;
 
 
+
+int jsonparse (JSON::ParseContext* context);
+
+/* "%code provides" blocks.  */
+#line 27 "Source/json_parser.ypp"
+
+int jsonlex(YYSTYPE* jsonlval, JSON::ParseContext* context);
+void jsonerror(JSON::ParseContext* context, const char* s);
+
+#line 106 "json_parser_bison.hh"
+
+#endif /* !YY_JSON_JSON_PARSER_BISON_HH_INCLUDED  */